@@ -0,0 +1,201 @@
+/*
+@Sean Siders
+sean.siders@icloud.com
+*/
+
+#include "Eigen.hpp"
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+//////// HELPERS
+
+//One rotation of a round, it zeroes A(p, q) and A(q, p)
+struct Rotation
+{
+    size_t p;
+    size_t q;
+    double c;
+    double s;
+};
+
+//Return the rotation that zeroes A(p, q) of the symmetric |A|, whose rows are |n| entries apart
+static Rotation rotation(const std::vector<double>& A, const size_t n, const size_t p, const size_t q)
+{
+    const double apq = A[p * n + q];
+    if (0.0 == apq) return Rotation{p, q, 1.0, 0.0};
+
+    //t = tan(angle) is the smaller root of t^2 + 2 * theta * t - 1 = 0
+    const double theta = (A[q * n + q] - A[p * n + p]) / (2.0 * apq);
+    const double t = (std::fabs(theta) > 1e150) ? 0.5 / theta :
+                     std::copysign(1.0, theta) / (std::fabs(theta) + std::sqrt(theta * theta + 1.0));
+    const double c = 1.0 / std::sqrt(t * t + 1.0);
+
+    return Rotation{p, q, c, t * c};
+}
+
+//Apply every rotation of a round to the columns of the |rows| x |n| row-major |M|, column p becomes c * p - s * q and
+//column q becomes s * p + c * q
+//The rotations touch disjoint columns, the rows are split across the thread pool
+static void rotateColumns(std::vector<double>& M, const size_t rows, const size_t n, const std::vector<Rotation>& round)
+{
+    parallelFor(rows, rows * round.size() * 4, [&](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; ++i)
+        {
+            double* row = &M[i * n];
+
+            for (const Rotation& r : round)
+            {
+                const double x = row[r.p];
+                const double y = row[r.q];
+
+                row[r.p] = r.c * x - r.s * y;
+                row[r.q] = r.s * x + r.c * y;
+            }
+        }
+    });
+}
+
+//Set |off| to the sum of the squares of the off diagonal entries of the |n| x |n| |A|
+//and |total| to the sum of the squares of every entry
+static void norms(const std::vector<double>& A, const size_t n, double& off, double& total)
+{
+    off = 0.0;
+    total = 0.0;
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        for (size_t j = 0; j < n; ++j)
+        {
+            const double square = A[i * n + j] * A[i * n + j];
+
+            total += square;
+            if (i != j) off += square;
+        }
+    }
+}
+
+//////// FUNCTIONS
+
+//True if the |order| x |order| row-major |buffer|, whose rows are |stride| entries apart, is symmetric
+//The entries are compared in tolerance of the largest, so a product such as A' * A that rounds differently on either
+//side of the diagonal still counts as symmetric
+bool symmetric(const size_t order, const double* buffer, const size_t stride)
+{
+    double largest = 0.0;
+
+    for (size_t i = 0; i < order; ++i)
+        for (size_t j = 0; j < order; ++j) largest = std::max(largest, std::fabs(buffer[i * stride + j]));
+
+    const double tolerance = EIGEN_SYMMETRY_TOLERANCE * std::numeric_limits<double>::epsilon() * largest;
+
+    for (size_t i = 0; i < order; ++i)
+    {
+        for (size_t j = i + 1; j < order; ++j)
+            if (std::fabs(buffer[i * stride + j] - buffer[j * stride + i]) > tolerance) return false;
+    }
+
+    return true;
+}
+
+//////// CONSTRUCTORS
+
+//Find the eigenvalues of the symmetric |order| x |order| row-major |buffer|, whose rows are |stride| entries apart
+//Sweeps are made until the off diagonal entries are negligible next to the whole matrix
+SymmetricEigen::SymmetricEigen(const size_t order, const double* buffer, const size_t stride, const bool withVectors) :
+    order(order), values(order), sweeps(0), converged(false)
+{
+    const size_t n = order;
+    std::vector<double> A(n * n);
+
+    for (size_t r = 0; r < n; ++r) std::copy(buffer + r * stride, buffer + r * stride + n, &A[r * n]);
+
+    std::vector<double> V;
+
+    if (withVectors)
+    {
+        V.assign(n * n, 0.0);
+        for (size_t i = 0; i < n; ++i) V[i * n + i] = 1.0;
+    }
+
+    //The tournament needs an even number of players, an odd order adds a player whose every pairing is skipped
+    const size_t players = n + (n % 2);
+    const double epsilon = std::numeric_limits<double>::epsilon();
+
+    std::vector<Rotation> round;
+    round.reserve(players / 2);
+
+    double off = 0.0;
+    double total = 0.0;
+    norms(A, n, off, total);
+
+    while (!(converged = (off <= epsilon * epsilon * total)) && sweeps < EIGEN_MAX_SWEEPS)
+    {
+        //Round r pairs player |players| - 1 with r, and r + k with r - k for every other k (the circle method)
+        for (size_t r = 0; r + 1 < players; ++r)
+        {
+            round.clear();
+
+            for (size_t k = 0; k < players / 2; ++k)
+            {
+                size_t p = (r + k) % (players - 1);
+                size_t q = (0 == k) ? players - 1 : (r + players - 1 - k) % (players - 1);
+
+                if (p > q) std::swap(p, q);
+                if (q < n) round.push_back(rotation(A, n, p, q));
+            }
+
+            //J' * A, each rotation replaces its own two rows
+            parallelFor(round.size(), round.size() * n * 4, [&](size_t begin, size_t end)
+            {
+                for (size_t i = begin; i < end; ++i)
+                {
+                    const Rotation& r = round[i];
+                    double* rowP = &A[r.p * n];
+                    double* rowQ = &A[r.q * n];
+
+                    for (size_t j = 0; j < n; ++j)
+                    {
+                        const double x = rowP[j];
+                        const double y = rowQ[j];
+
+                        rowP[j] = r.c * x - r.s * y;
+                        rowQ[j] = r.s * x + r.c * y;
+                    }
+                }
+            });
+
+            //(J' * A) * J, and the eigenvectors V * J
+            rotateColumns(A, n, n, round);
+            if (withVectors) rotateColumns(V, n, n, round);
+
+            //The rotated pairs are zero up to roundoff, they are set to exactly zero
+            for (const Rotation& r : round)
+            {
+                A[r.p * n + r.q] = 0.0;
+                A[r.q * n + r.p] = 0.0;
+            }
+        }
+
+        ++sweeps;
+        norms(A, n, off, total);
+    }
+
+    //Sort the eigenvalues ascending, carrying their eigenvectors along
+    std::vector<size_t> rank(n);
+    std::iota(rank.begin(), rank.end(), 0);
+    std::stable_sort(rank.begin(), rank.end(), [&](size_t a, size_t b) { return A[a * n + a] < A[b * n + b]; });
+
+    for (size_t i = 0; i < n; ++i) values[i] = A[rank[i] * n + rank[i]];
+
+    if (withVectors)
+    {
+        vectors.resize(n * n);
+
+        for (size_t r = 0; r < n; ++r)
+            for (size_t c = 0; c < n; ++c) vectors[r * n + c] = V[r * n + rank[c]];
+    }
+}
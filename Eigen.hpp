@@ -0,0 +1,72 @@
+/*
+Eigenvalues and eigenvectors of symmetric matrices by the cyclic Jacobi method. Each Jacobi rotation zeroes one pair of
+off diagonal entries, A' = J' * A * J, and a sweep rotates every pair once. The off diagonal entries shrink
+quadratically once they are small, so a handful of sweeps leaves a diagonal matrix of eigenvalues, and the product of the
+rotations holds the eigenvectors as its columns. Jacobi is slower than tridiagonalization for large matrices, but it
+computes even tiny eigenvalues to high relative accuracy.
+
+PARALLEL ORDERING
+The pairs of a sweep are visited in round-robin (tournament) order: every round pairs each index with exactly one other,
+so the rotations of a round touch disjoint rows and columns and are computed independently. A round applies all of its
+rotations to the rows of A, split across the thread pool by pair, then to the columns of A and of the eigenvectors, split
+by row. Every entry is still computed by a single thread in a fixed order, so results are identical for any pool size.
+
+@Sean Siders
+sean.siders@icloud.com
+*/
+
+#ifndef EIGEN_HPP_
+#define EIGEN_HPP_
+
+#include <cstddef>
+#include <vector>
+
+//The most sweeps made before giving up on convergence, a symmetric matrix normally converges in under 15
+const size_t EIGEN_MAX_SWEEPS = 50;
+
+//A matrix is symmetric if every A(i, j) is within this many units of roundoff of the largest entry from A(j, i)
+const double EIGEN_SYMMETRY_TOLERANCE = 64;
+
+//True if the |order| x |order| row-major |buffer|, whose rows are |stride| entries apart, is symmetric
+bool symmetric(const size_t order, const double* buffer, const size_t stride);
+
+class SymmetricEigen
+{
+    public:
+    //////// CONSTRUCTORS
+
+    //Find the eigenvalues of the symmetric |order| x |order| row-major |buffer|, whose rows are |stride| entries apart
+    //The eigenvectors are found as well when |withVectors|
+    SymmetricEigen(const size_t order, const double* buffer, const size_t stride, const bool withVectors);
+
+    //////// GETTERS
+
+    size_t _order() const { return order; }
+
+    //The eigenvalues in ascending order
+    const double* _values() const { return values.data(); }
+
+    //The eigenvectors as the columns of an |_order| x |_order| row-major matrix, column i belongs to |_values()[i]|
+    //Null unless the eigenvectors were requested
+    const double* _vectors() const { return vectors.empty() ? nullptr : vectors.data(); }
+
+    //The number of sweeps made
+    size_t _sweeps() const { return sweeps; }
+
+    //False if the off diagonal entries were still significant after |EIGEN_MAX_SWEEPS| sweeps
+    bool _converged() const { return converged; }
+
+    private:
+    //The number of rows and columns of the matrix
+    size_t order;
+
+    std::vector<double> values;
+
+    std::vector<double> vectors;
+
+    size_t sweeps;
+
+    bool converged;
+};
+
+#endif //EIGEN_HPP_
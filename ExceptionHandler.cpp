@@ -15,9 +15,20 @@ std::ostream& operator<<(std::ostream& out, const ExceptionHandler& ex)
 std::ostream& operator<<(std::ostream& out, const InvalidOperation& ex)
 {
     out << "\nINVALID OPERATION : ";
-    ex.lhs->displayIdentifier(out);
-    out << " " << ex.op << " ";
-    ex.rhs->displayIdentifier(out);
+
+    if (!ex.function.empty())
+    {
+        out << ex.function << ' ';
+        ex.lhs->displayIdentifier(out);
+    }
+
+    else
+    {
+        ex.lhs->displayIdentifier(out);
+        out << " " << ex.op << " ";
+        ex.rhs->displayIdentifier(out);
+    }
+
     out << '\n';
     out << ex.message;
 
@@ -38,3 +49,9 @@ InvalidOperation::InvalidOperation(const Matrix* lhs, const char op, const Matri
     ExceptionHandler(message), lhs(lhs), op(op), rhs(rhs)
 {
 }
+
+//An invalid operation |function| applied to the single matrix |operand|
+InvalidOperation::InvalidOperation(const std::string& function, const Matrix* operand, const std::string& message) :
+    ExceptionHandler(message), lhs(operand), op('\0'), rhs(nullptr), function(function)
+{
+}
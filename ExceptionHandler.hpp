@@ -43,10 +43,16 @@ class InvalidOperation : public ExceptionHandler
     InvalidOperation();
     InvalidOperation(const Matrix* lhs, const char op, const Matrix* rhs, const std::string& message);
 
+    //An invalid operation |function| applied to the single matrix |operand|
+    InvalidOperation(const std::string& function, const Matrix* operand, const std::string& message);
+
     private:
     const Matrix* lhs;
     const char op;
     const Matrix* rhs;
+
+    //The name of a single operand operation, empty for a binary operation
+    std::string function;
 };
 
 #endif //EXCEPTION_HANDLER_HPP_
@@ -0,0 +1,328 @@
+/*
+Expression templates for elementwise matrix arithmetic. Adding or subtracting matrices does not compute anything, it
+builds a lightweight expression object that records the operands. The whole chain is evaluated when it is assigned into
+a |Matrix|, in a single pass over memory with no intermediate matrices:
+
+    Matrix E = A + B - C + D;
+
+EVALUATION
+The result is produced |EXPRESSION_CHUNK| entries at a time, a chunk small enough to stay in the L1 cache. The first
+operand is copied into the chunk and every other operand is added or subtracted into it with the SIMD kernels, so each
+operand is read once and the result is written once, regardless of the length of the chain. Large results are split
+into row blocks across the thread pool.
+
+RUNTIME CHAINS
+|Chain| is the same kind of expression for chains whose length is only known at runtime, as typed by the user. Each of
+its matrices may carry a scalar factor, which is applied as the matrix is added (2.5 * A + B is a single pass).
+
+REQUIRED MEMBERS OF AN EXPRESSION
+LEAF : true only for a single matrix operand
+first() : the leftmost matrix, which supplies the order and identifier of the result
+evaluate() : write the chunk of the expression that begins at |offset|
+accumulate() : add (or subtract, when |negate|) the chunk of the expression that begins at |offset|
+
+Every operand of an expression must be of the same order and stored dense, callers check |Matrix::orderMatch| beforehand.
+Sparse operands are added separately, see |Interface::evaluateExpression|.
+
+@Sean Siders
+sean.siders@icloud.com
+*/
+
+#ifndef EXPRESSION_HPP_
+#define EXPRESSION_HPP_
+
+#include <cstring>
+#include <vector>
+#include "Matrix.hpp"
+#include "Kernels.hpp"
+#include "ThreadPool.hpp"
+
+//The number of entries evaluated at a time, 8 KiB of doubles
+const size_t EXPRESSION_CHUNK = 1024;
+
+//////// EXPRESSION BASE
+
+//Every expression derives from |Expression| with itself as |E|, so operators can accept any expression
+template <typename E>
+class Expression
+{
+    public:
+    //The concrete expression
+    const E& self() const
+    {
+        return static_cast<const E&>(*this);
+    }
+};
+
+//////// MATRIX OPERAND
+
+//A single matrix operand, held by reference
+class MatrixTerm : public Expression<MatrixTerm>
+{
+    public:
+    static constexpr bool LEAF = true;
+
+    explicit MatrixTerm(const Matrix& source) : source(source) {}
+
+    const Matrix& first() const
+    {
+        return source;
+    }
+
+    //The entries of the operand that begin at |offset|
+    const double* entries(const size_t offset) const
+    {
+        return source._buffer() + offset;
+    }
+
+    void evaluate(double* out, const size_t offset, const size_t count, const KernelTable&) const
+    {
+        std::memcpy(out, entries(offset), count * sizeof(double));
+    }
+
+    void accumulate(double* out, const size_t offset, const size_t count, const bool negate, const KernelTable& kernel) const
+    {
+        if (negate) kernel.subtract(out, entries(offset), count);
+        else kernel.add(out, entries(offset), count);
+    }
+
+    private:
+    const Matrix& source;
+};
+
+//////// SUM AND DIFFERENCE
+
+//|lhs| + |rhs|, or |lhs| - |rhs| when |SUBTRACT|
+//Child expressions are held by value, so a chain never refers to a destroyed temporary
+template <typename L, typename R, bool SUBTRACT>
+class Combination : public Expression<Combination<L, R, SUBTRACT>>
+{
+    public:
+    static constexpr bool LEAF = false;
+
+    Combination(const L& lhs, const R& rhs) : lhs(lhs), rhs(rhs) {}
+
+    const Matrix& first() const
+    {
+        return lhs.first();
+    }
+
+    void evaluate(double* out, const size_t offset, const size_t count, const KernelTable& kernel) const
+    {
+        //Two plain matrices are combined in one kernel pass
+        if constexpr (L::LEAF && R::LEAF)
+        {
+            if (SUBTRACT) kernel.difference(out, lhs.entries(offset), rhs.entries(offset), count);
+            else kernel.sum(out, lhs.entries(offset), rhs.entries(offset), count);
+        }
+
+        else
+        {
+            lhs.evaluate(out, offset, count, kernel);
+            rhs.accumulate(out, offset, count, SUBTRACT, kernel);
+        }
+    }
+
+    void accumulate(double* out, const size_t offset, const size_t count, const bool negate, const KernelTable& kernel) const
+    {
+        lhs.accumulate(out, offset, count, negate, kernel);
+        rhs.accumulate(out, offset, count, negate != SUBTRACT, kernel);
+    }
+
+    private:
+    const L lhs;
+    const R rhs;
+};
+
+template <typename L, typename R>
+using Sum = Combination<L, R, false>;
+
+template <typename L, typename R>
+using Difference = Combination<L, R, true>;
+
+//////// RUNTIME CHAIN
+
+//A chain of matrices, each added or subtracted, whose length is only known at runtime
+class Chain : public Expression<Chain>
+{
+    public:
+    static constexpr bool LEAF = false;
+
+    //Begin the chain with |first| multiplied by |scale|, subtracted from zero if |negate|
+    explicit Chain(const Matrix& first, const bool negate = false, const double scale = 1.0)
+    {
+        terms.push_back(&first);
+        negated.push_back(negate);
+        scales.push_back(scale);
+    }
+
+    //Append |source| multiplied by |scale| to the chain, subtracted if |negate|
+    void append(const Matrix& source, const bool negate, const double scale = 1.0)
+    {
+        terms.push_back(&source);
+        negated.push_back(negate);
+        scales.push_back(scale);
+    }
+
+    //Return the number of matrices in the chain
+    size_t size() const
+    {
+        return terms.size();
+    }
+
+    const Matrix& first() const
+    {
+        return *terms.front();
+    }
+
+    void evaluate(double* out, const size_t offset, const size_t count, const KernelTable& kernel) const
+    {
+        if (1.0 != scales[0])
+        {
+            kernel.scale(out, negated[0] ? -scales[0] : scales[0], terms[0]->_buffer() + offset, count);
+            accumulateFrom(1, out, offset, count, false, kernel);
+        }
+
+        else if (negated[0])
+        {
+            std::memset(out, 0, count * sizeof(double));
+            accumulateFrom(0, out, offset, count, false, kernel);
+        }
+
+        else
+        {
+            std::memcpy(out, terms[0]->_buffer() + offset, count * sizeof(double));
+            accumulateFrom(1, out, offset, count, false, kernel);
+        }
+    }
+
+    void accumulate(double* out, const size_t offset, const size_t count, const bool negate, const KernelTable& kernel) const
+    {
+        accumulateFrom(0, out, offset, count, negate, kernel);
+    }
+
+    private:
+    //The matrices of the chain, in order
+    std::vector<const Matrix*> terms;
+
+    //True where the matching entry of |terms| is subtracted
+    std::vector<bool> negated;
+
+    //The factor every entry of the matching entry of |terms| is multiplied by
+    std::vector<double> scales;
+
+    void accumulateFrom(const size_t begin, double* out, const size_t offset, const size_t count, const bool negate,
+                        const KernelTable& kernel) const
+    {
+        for (size_t i = begin; i < terms.size(); ++i)
+        {
+            const bool subtract = (negate != negated[i]);
+
+            if (1.0 != scales[i]) kernel.axpy(out, subtract ? -scales[i] : scales[i], terms[i]->_buffer() + offset, count);
+            else if (subtract) kernel.subtract(out, terms[i]->_buffer() + offset, count);
+            else kernel.add(out, terms[i]->_buffer() + offset, count);
+        }
+    }
+};
+
+//////// OPERATORS
+
+inline Sum<MatrixTerm, MatrixTerm> operator+(const Matrix& lhs, const Matrix& rhs)
+{
+    return Sum<MatrixTerm, MatrixTerm>(MatrixTerm(lhs), MatrixTerm(rhs));
+}
+
+template <typename R>
+Sum<MatrixTerm, R> operator+(const Matrix& lhs, const Expression<R>& rhs)
+{
+    return Sum<MatrixTerm, R>(MatrixTerm(lhs), rhs.self());
+}
+
+template <typename L>
+Sum<L, MatrixTerm> operator+(const Expression<L>& lhs, const Matrix& rhs)
+{
+    return Sum<L, MatrixTerm>(lhs.self(), MatrixTerm(rhs));
+}
+
+template <typename L, typename R>
+Sum<L, R> operator+(const Expression<L>& lhs, const Expression<R>& rhs)
+{
+    return Sum<L, R>(lhs.self(), rhs.self());
+}
+
+inline Difference<MatrixTerm, MatrixTerm> operator-(const Matrix& lhs, const Matrix& rhs)
+{
+    return Difference<MatrixTerm, MatrixTerm>(MatrixTerm(lhs), MatrixTerm(rhs));
+}
+
+template <typename R>
+Difference<MatrixTerm, R> operator-(const Matrix& lhs, const Expression<R>& rhs)
+{
+    return Difference<MatrixTerm, R>(MatrixTerm(lhs), rhs.self());
+}
+
+template <typename L>
+Difference<L, MatrixTerm> operator-(const Expression<L>& lhs, const Matrix& rhs)
+{
+    return Difference<L, MatrixTerm>(lhs.self(), MatrixTerm(rhs));
+}
+
+template <typename L, typename R>
+Difference<L, R> operator-(const Expression<L>& lhs, const Expression<R>& rhs)
+{
+    return Difference<L, R>(lhs.self(), rhs.self());
+}
+
+//Display an unevaluated expression by evaluating it first
+template <typename E>
+std::ostream& operator<<(std::ostream& out, const Expression<E>& expression)
+{
+    return out << Matrix(expression);
+}
+
+//////// MATRIX EVALUATION
+
+//Evaluate |expression| into a new matrix, named after the leftmost operand
+template <typename E>
+Matrix::Matrix(const Expression<E>& expression) :
+    identifier(expression.self().first().identifier), rows(expression.self().first().rows),
+    columns(expression.self().first().columns), stride(expression.self().first().stride), matrix(nullptr), sparse(nullptr),
+    stringValid(false)
+{
+    evaluate(expression.self());
+}
+
+//Evaluate |expression| and replace the entries of this matrix with the result, keeping the |identifier|
+//The result is built in a new buffer, so |expression| may refer to this matrix
+template <typename E>
+Matrix& Matrix::operator=(const Expression<E>& expression)
+{
+    Matrix result(expression);
+
+    clearMatrix();
+    take(std::move(result));
+
+    return *this;
+}
+
+//Allocate |matrix| and write every entry of |expression| into it, one cache-sized chunk at a time
+template <typename E>
+void Matrix::evaluate(const E& expression)
+{
+    matrix = allocate(rows, stride);
+
+    const KernelTable& kernel = kernels();
+
+    parallelFor(rows, rows * stride, [&](size_t begin, size_t end)
+    {
+        const size_t last = end * stride;
+
+        for (size_t offset = begin * stride; offset < last; offset += EXPRESSION_CHUNK)
+        {
+            const size_t count = (last - offset < EXPRESSION_CHUNK) ? last - offset : EXPRESSION_CHUNK;
+            expression.evaluate(matrix + offset, offset, count, kernel);
+        }
+    });
+}
+
+#endif //EXPRESSION_HPP_
@@ -0,0 +1,53 @@
+/*
+@Sean Siders
+sean.siders@icloud.com
+*/
+
+#include "Fixed.hpp"
+
+//////// HELPERS
+
+template <size_t N>
+static void multiplyOrder(const double* A, const size_t lda, const double* B, const size_t ldb, double* C, const size_t ldc)
+{
+    (FixedMatrix<N, N>(A, lda) * FixedMatrix<N, N>(B, ldb)).store(C, ldc);
+}
+
+template <size_t N>
+static void combineOrder(double* Y, const size_t ldy, const double* X, const size_t ldx, const bool subtract)
+{
+    FixedMatrix<N, N> result(Y, ldy);
+
+    if (subtract) result -= FixedMatrix<N, N>(X, ldx);
+    else result += FixedMatrix<N, N>(X, ldx);
+
+    result.store(Y, ldy);
+}
+
+//////// FUNCTIONS
+
+//C = A * B for square |order| x |order| operands, |fixedWorthwhile| must hold
+void fixedMultiply(const size_t order, const double* A, const size_t lda, const double* B, const size_t ldb,
+                   double* C, const size_t ldc)
+{
+    switch (order)
+    {
+        case 2 : multiplyOrder<2>(A, lda, B, ldb, C, ldc); break;
+        case 3 : multiplyOrder<3>(A, lda, B, ldb, C, ldc); break;
+        case 4 : multiplyOrder<4>(A, lda, B, ldb, C, ldc); break;
+        default : break;
+    }
+}
+
+//Y += X, or Y -= X when |subtract|, for square |order| x |order| operands, |fixedWorthwhile| must hold
+void fixedCombine(const size_t order, double* Y, const size_t ldy, const double* X, const size_t ldx,
+                  const bool subtract)
+{
+    switch (order)
+    {
+        case 2 : combineOrder<2>(Y, ldy, X, ldx, subtract); break;
+        case 3 : combineOrder<3>(Y, ldy, X, ldx, subtract); break;
+        case 4 : combineOrder<4>(Y, ldy, X, ldx, subtract); break;
+        default : break;
+    }
+}
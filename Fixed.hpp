@@ -0,0 +1,143 @@
+/*
+Matrices whose order is fixed at compile time, for the tiny transforms (2x2, 3x3, 4x4) that make up much of the traffic
+through Lina. The entries live inside the object itself, so a |FixedMatrix| on the stack never touches the heap, and
+every loop is unrolled at compile time over the |constexpr| dimensions. Mismatched orders fail to compile, so no order
+is ever checked at runtime.
+
+    FixedMatrix<3, 3> R = ...;
+    FixedMatrix<3, 1> v = ...;
+    FixedMatrix<3, 1> w = R * v + v;
+
+ROUTING FROM |Matrix|
+|Matrix| routes square products and sums of order |FIXED_MIN| to |FIXED_MAX| through |fixedMultiply| and |fixedCombine|,
+which load the operands into |FixedMatrix| objects, compute on the stack and store the result.
+
+@Sean Siders
+sean.siders@icloud.com
+*/
+
+#ifndef FIXED_HPP_
+#define FIXED_HPP_
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+//The smallest and largest square order routed to |FixedMatrix| by |Matrix|
+const size_t FIXED_MIN = 2;
+const size_t FIXED_MAX = 4;
+
+//////// UNROLLING
+
+//Call |body| with std::integral_constant<size_t, I> for every I in the sequence, each call a separate statement
+template <size_t... I, typename F>
+constexpr void unroll(std::index_sequence<I...>, F&& body)
+{
+    (body(std::integral_constant<size_t, I>()), ...);
+}
+
+//Call |body| for every index in [0, |N|), fully unrolled
+template <size_t N, typename F>
+constexpr void unroll(F&& body)
+{
+    unroll(std::make_index_sequence<N>(), std::forward<F>(body));
+}
+
+//////// FIXED MATRIX
+
+template <size_t R, size_t C>
+class FixedMatrix
+{
+    public:
+    static constexpr size_t ROWS = R;
+    static constexpr size_t COLUMNS = C;
+
+    //////// CONSTRUCTORS
+
+    //Every entry is zero
+    constexpr FixedMatrix() : entries{} {}
+
+    //Load the entries from the row-major |buffer|, whose rows are |stride| entries apart
+    FixedMatrix(const double* buffer, const size_t stride) : entries{}
+    {
+        unroll<R * C>([&](auto i) { entries[i] = buffer[i / C * stride + i % C]; });
+    }
+
+    //////// OPERATORS
+
+    constexpr double& operator()(const size_t r, const size_t c) { return entries[r * C + c]; }
+    constexpr const double& operator()(const size_t r, const size_t c) const { return entries[r * C + c]; }
+
+    constexpr FixedMatrix& operator+=(const FixedMatrix& rhs)
+    {
+        unroll<R * C>([&](auto i) { entries[i] += rhs.entries[i]; });
+        return *this;
+    }
+
+    constexpr FixedMatrix& operator-=(const FixedMatrix& rhs)
+    {
+        unroll<R * C>([&](auto i) { entries[i] -= rhs.entries[i]; });
+        return *this;
+    }
+
+    constexpr FixedMatrix operator+(const FixedMatrix& rhs) const
+    {
+        FixedMatrix sum(*this);
+        return sum += rhs;
+    }
+
+    constexpr FixedMatrix operator-(const FixedMatrix& rhs) const
+    {
+        FixedMatrix difference(*this);
+        return difference -= rhs;
+    }
+
+    //Each entry of the product sums its terms in order of the shared dimension, as |Matrix| does
+    template <size_t N>
+    constexpr FixedMatrix<R, N> operator*(const FixedMatrix<C, N>& rhs) const
+    {
+        FixedMatrix<R, N> product;
+
+        unroll<R * N>([&](auto i)
+        {
+            constexpr size_t r = decltype(i)::value / N;
+            constexpr size_t c = decltype(i)::value % N;
+
+            double sum = 0.0;
+            unroll<C>([&](auto k) { sum += entries[r * C + k] * rhs(k, c); });
+            product(r, c) = sum;
+        });
+
+        return product;
+    }
+
+    //////// PUBLIC FUNCTIONS
+
+    //Store the entries into the row-major |buffer|, whose rows are |stride| entries apart
+    void store(double* buffer, const size_t stride) const
+    {
+        unroll<R * C>([&](auto i) { buffer[i / C * stride + i % C] = entries[i]; });
+    }
+
+    private:
+    //The row-major entries
+    double entries[R * C];
+};
+
+//////// ROUTING FROM MATRIX
+
+//True if an |m| x |k| by |k| x |n| product is routed to |fixedMultiply|
+inline bool fixedWorthwhile(const size_t m, const size_t n, const size_t k)
+{
+    return m == n && n == k && m >= FIXED_MIN && m <= FIXED_MAX;
+}
+
+//C = A * B for square |order| x |order| operands, |fixedWorthwhile| must hold
+void fixedMultiply(const size_t order, const double* A, const size_t lda, const double* B, const size_t ldb,
+                   double* C, const size_t ldc);
+
+//Y += X, or Y -= X when |subtract|, for square |order| x |order| operands, |fixedWorthwhile| must hold
+void fixedCombine(const size_t order, double* Y, const size_t ldy, const double* X, const size_t ldx,
+                  const bool subtract);
+
+#endif //FIXED_HPP_
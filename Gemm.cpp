@@ -0,0 +1,213 @@
+/*
+@Sean Siders
+sean.siders@icloud.com
+*/
+
+#include "Gemm.hpp"
+#include "Kernels.hpp"
+#include "ThreadPool.hpp"
+#include <new>
+
+//////// PACKED PANEL STORAGE
+
+//An aligned scratch buffer that holds a packed panel of A or B for the duration of one |gemm| call
+class PackBuffer
+{
+    public:
+    explicit PackBuffer(const size_t size) :
+        data(static_cast<double*>(::operator new[](size * sizeof(double), std::align_val_t(64))))
+    {
+    }
+
+    ~PackBuffer()
+    {
+        ::operator delete[](data, std::align_val_t(64));
+    }
+
+    PackBuffer(const PackBuffer&) = delete;
+    PackBuffer& operator=(const PackBuffer&) = delete;
+
+    double* data;
+};
+
+//////// PACKING
+
+//Pack the |mc| x |kc| block of A into |GEMM_MR| row micro-panels
+//Within a micro-panel, the |GEMM_MR| entries of each column are contiguous
+//Rows past |mc| are zero filled so the micro-kernel never needs an edge case
+//When |trans|, the block is read from the |kc| x |mc| transpose stored in A, whose columns are then contiguous
+static void packA(const bool trans, const size_t mc, const size_t kc, const double* A, const size_t lda, double* packed)
+{
+    for (size_t i0 = 0; i0 < mc; i0 += GEMM_MR)
+    {
+        for (size_t p = 0; p < kc; ++p)
+        {
+            for (size_t i = 0; i < GEMM_MR; ++i)
+            {
+                if (i0 + i >= mc) *packed++ = 0.0;
+                else *packed++ = trans ? A[p * lda + i0 + i] : A[(i0 + i) * lda + p];
+            }
+        }
+    }
+}
+
+//Pack the |kc| x |nc| block of B into |GEMM_NR| column micro-panels
+//Within a micro-panel, the |GEMM_NR| entries of each row are contiguous
+//Columns past |nc| are zero filled so the micro-kernel never needs an edge case
+//When |trans|, the block is read from the |nc| x |kc| transpose stored in B
+static void packB(const bool trans, const size_t kc, const size_t nc, const double* B, const size_t ldb, double* packed)
+{
+    for (size_t j0 = 0; j0 < nc; j0 += GEMM_NR)
+    {
+        for (size_t p = 0; p < kc; ++p)
+        {
+            if (trans)
+            {
+                for (size_t j = 0; j < GEMM_NR; ++j)
+                    *packed++ = (j0 + j < nc) ? B[(j0 + j) * ldb + p] : 0.0;
+
+                continue;
+            }
+
+            const double* row = B + p * ldb + j0;
+
+            for (size_t j = 0; j < GEMM_NR; ++j)
+                *packed++ = (j0 + j < nc) ? row[j] : 0.0;
+        }
+    }
+}
+
+//////// MACRO-KERNEL
+
+//Run the micro-kernel over every tile of an |mc| x |nc| block of C
+//Partial tiles on the bottom and right edges are computed in a scratch tile, then copied back
+//|microKernel| is taken from the kernel table for the instruction set in use
+static void macroKernel(const size_t mc, const size_t nc, const size_t kc, const double alpha,
+                        const double* packedA, const double* packedB, double* C, const size_t ldc,
+                        void (*microKernel)(const size_t, const double, const double*, const double*, double*, const size_t))
+{
+    for (size_t j0 = 0; j0 < nc; j0 += GEMM_NR)
+    {
+        const size_t nr = (nc - j0 < GEMM_NR) ? nc - j0 : GEMM_NR;
+
+        for (size_t i0 = 0; i0 < mc; i0 += GEMM_MR)
+        {
+            const size_t mr = (mc - i0 < GEMM_MR) ? mc - i0 : GEMM_MR;
+            const double* a = packedA + i0 * kc;
+            const double* b = packedB + j0 * kc;
+            double* tile = C + i0 * ldc + j0;
+
+            if (mr == GEMM_MR && nr == GEMM_NR)
+            {
+                microKernel(kc, alpha, a, b, tile, ldc);
+                continue;
+            }
+
+            double edge[GEMM_MR * GEMM_NR] = {};
+            microKernel(kc, alpha, a, b, edge, GEMM_NR);
+
+            for (size_t i = 0; i < mr; ++i)
+            {
+                for (size_t j = 0; j < nr; ++j) tile[i * ldc + j] += edge[i * GEMM_NR + j];
+            }
+        }
+    }
+}
+
+//////// FUNCTIONS
+
+//True if an |m| x |k| by |k| x |n| product is large enough to be worth the blocked engine
+bool gemmWorthwhile(const size_t m, const size_t n, const size_t k)
+{
+    return m >= GEMM_MR && n >= GEMM_NR && m * n * k >= GEMM_THRESHOLD;
+}
+
+//C = alpha * A * B + beta * C
+//A is |m| x |k|, B is |k| x |n| and C is |m| x |n|
+//When |beta| is zero, C is overwritten without being read
+void gemm(const size_t m, const size_t n, const size_t k, const double alpha,
+          const double* A, const size_t lda, const double* B, const size_t ldb,
+          const double beta, double* C, const size_t ldc)
+{
+    gemm(false, false, m, n, k, alpha, A, lda, B, ldb, beta, C, ldc);
+}
+
+//C = alpha * op(A) * op(B) + beta * C, where op transposes its operand when |transA| or |transB| is set
+//op(A) is |m| x |k| and op(B) is |k| x |n|, so a transposed A is stored |k| x |m| and a transposed B |n| x |k|
+void gemm(const bool transA, const bool transB, const size_t m, const size_t n, const size_t k, const double alpha,
+          const double* A, const size_t lda, const double* B, const size_t ldb,
+          const double beta, double* C, const size_t ldc)
+{
+    if (!m || !n) return;
+
+    //Apply |beta| once up front, every packed slice then accumulates into C
+    if (beta != 1.0)
+    {
+        for (size_t i = 0; i < m; ++i)
+        {
+            double* row = C + i * ldc;
+
+            for (size_t j = 0; j < n; ++j) row[j] = (beta == 0.0) ? 0.0 : beta * row[j];
+        }
+    }
+
+    if (!k || alpha == 0.0) return;
+
+    //The micro-kernel for the instruction set chosen at startup
+    const auto microKernel = kernels().microKernel;
+
+    const size_t ncMax = (n < GEMM_NC) ? n : GEMM_NC;
+    const size_t kcMax = (k < GEMM_KC) ? k : GEMM_KC;
+
+    PackBuffer packedB(kcMax * ((ncMax + GEMM_NR - 1) / GEMM_NR * GEMM_NR));
+
+    //Each |GEMM_MC| block of rows is one unit of work
+    //When there are fewer blocks than threads, the columns of each block are split into slices as well
+    ThreadPool& pool = threadPool();
+    const size_t rowBlocks = (m + GEMM_MC - 1) / GEMM_MC;
+    const size_t threads = (m * n * k < PARALLEL_THRESHOLD) ? 1 : pool.size();
+
+    for (size_t jc = 0; jc < n; jc += GEMM_NC)
+    {
+        const size_t nc = (n - jc < GEMM_NC) ? n - jc : GEMM_NC;
+
+        for (size_t pc = 0; pc < k; pc += GEMM_KC)
+        {
+            const size_t kc = (k - pc < GEMM_KC) ? k - pc : GEMM_KC;
+
+            packB(transB, kc, nc, transB ? B + jc * ldb + pc : B + pc * ldb + jc, ldb, packedB.data);
+
+            const size_t panels = (nc + GEMM_NR - 1) / GEMM_NR;
+            size_t slices = (threads > rowBlocks) ? (threads + rowBlocks - 1) / rowBlocks : 1;
+            if (slices > panels) slices = panels;
+
+            //One unit is the rows of one |GEMM_MC| block, restricted to the panels of one column slice
+            const auto computeUnit = [&](size_t unit)
+            {
+                //Each thread packs blocks of A into its own buffer, allocated once per thread
+                static thread_local PackBuffer packedA(GEMM_KC * GEMM_MC);
+
+                const size_t ic = unit / slices * GEMM_MC;
+                const size_t mc = (m - ic < GEMM_MC) ? m - ic : GEMM_MC;
+                const size_t slice = unit % slices;
+
+                //The columns covered by the |GEMM_NR| wide panels of this slice
+                const size_t j0 = panels * slice / slices * GEMM_NR;
+                const size_t end = panels * (slice + 1) / slices * GEMM_NR;
+                const size_t j1 = (end < nc) ? end : nc;
+
+                packA(transA, mc, kc, transA ? A + pc * lda + ic : A + ic * lda + pc, lda, packedA.data);
+                macroKernel(mc, j1 - j0, kc, alpha, packedA.data, packedB.data + j0 * kc,
+                            C + ic * ldc + jc + j0, ldc, microKernel);
+            };
+
+            //Every unit writes a disjoint tile of C, so the result does not depend on the pool size
+            if (1 == threads)
+            {
+                for (size_t unit = 0; unit < rowBlocks; ++unit) computeUnit(unit);
+            }
+
+            else pool.run(rowBlocks * slices, computeUnit);
+        }
+    }
+}
@@ -0,0 +1,64 @@
+/*
+The general matrix multiply (GEMM) engine used by |Matrix| for large products. The product is computed in the same
+manner as optimized BLAS libraries:
+
+BLOCKING
+- The shared dimension is split into |GEMM_KC| deep slices, the rows of A into |GEMM_MC| high blocks and the columns of B
+  into |GEMM_NC| wide blocks, so the working set of each level fits the L1, L2 and L3 caches respectively
+- Each slice of B and each block of A are packed into contiguous panels, ordered exactly as the micro-kernel reads them
+- The micro-kernel keeps a |GEMM_MR| x |GEMM_NR| tile of C in registers while it walks the packed panels
+
+Every operand is row-major with an explicit row stride (|lda|, |ldb|, |ldc|), matching the buffer layout of |Matrix|.
+
+TRANSPOSED OPERANDS
+A or B may be read as the transpose of the buffer that holds it. Only the packing routines read the operands, so a
+transposed operand is gathered into the same panels as any other and the transpose is never formed in memory.
+
+@Sean Siders
+sean.siders@icloud.com
+*/
+
+#ifndef GEMM_HPP_
+#define GEMM_HPP_
+
+#include <cstddef>
+
+//////// BLOCKING PARAMETERS
+
+//Rows of C held in registers by the micro-kernel
+const size_t GEMM_MR = 4;
+
+//Columns of C held in registers by the micro-kernel
+const size_t GEMM_NR = 8;
+
+//Depth of a packed slice of the shared dimension (the packed B micro-panel stays in L1)
+const size_t GEMM_KC = 256;
+
+//Rows of A packed per block (the packed A block stays in L2)
+const size_t GEMM_MC = 96;
+
+//Columns of B packed per block (the packed B block stays in L3)
+const size_t GEMM_NC = 4096;
+
+//Products with fewer multiply-adds than this are faster without packing
+const size_t GEMM_THRESHOLD = 64 * 64 * 64;
+
+//////// FUNCTIONS
+
+//True if an |m| x |k| by |k| x |n| product is large enough to be worth the blocked engine
+bool gemmWorthwhile(const size_t m, const size_t n, const size_t k);
+
+//C = alpha * A * B + beta * C
+//A is |m| x |k|, B is |k| x |n| and C is |m| x |n|
+//When |beta| is zero, C is overwritten without being read
+void gemm(const size_t m, const size_t n, const size_t k, const double alpha,
+          const double* A, const size_t lda, const double* B, const size_t ldb,
+          const double beta, double* C, const size_t ldc);
+
+//C = alpha * op(A) * op(B) + beta * C, where op transposes its operand when |transA| or |transB| is set
+//op(A) is |m| x |k| and op(B) is |k| x |n|, so a transposed A is stored |k| x |m| and a transposed B |n| x |k|
+void gemm(const bool transA, const bool transB, const size_t m, const size_t n, const size_t k, const double alpha,
+          const double* A, const size_t lda, const double* B, const size_t ldb,
+          const double beta, double* C, const size_t ldc);
+
+#endif //GEMM_HPP_
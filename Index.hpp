@@ -0,0 +1,180 @@
+/*
+An open addressing hash index of items by their identifier, kept alongside a |Tree| of the same items. The tree owns
+the items and keeps them in order for listing and prefix removal, while the index finds an item by its identifier in
+a constant number of probes instead of a comparison of strings at every level of the tree.
+
+SLOTS
+Each slot holds the full hash of an identifier and a pointer to its item, in one flat array whose size is a power of
+two. A lookup hashes its key once and probes neighbouring slots from the key's home slot, comparing the stored hashes
+and only reading an identifier when the hashes match. The index grows by doubling before it is half full, so a
+lookup rarely probes more than a few slots of one or two cache lines.
+
+KEYS
+Lookups take a |std::string_view|, so a key is found from a |std::string| or a slice of a line of input without
+building a string. The index keeps no copy of any identifier, it reads the identifier from the item itself, so an item
+may be overwritten in place under the same identifier without touching the index.
+
+REMOVAL
+A removed entry is not marked with a tombstone. The entries after it in the same run of slots are shifted back over
+the hole wherever that keeps them reachable from their home slot, so the probes of a lookup never lengthen with
+removals.
+
+REQUIRED MEMBER
+_identifier() : the key of the item, convertible to |std::string_view|
+
+@Sean Siders
+sean.siders@icloud.com
+*/
+
+#ifndef INDEX_HPP_
+#define INDEX_HPP_
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <string_view>
+#include <vector>
+
+//The number of slots in an index once its first item is inserted
+const size_t INDEX_FIRST_CAPACITY = 16;
+
+template <typename T>
+class HashIndex
+{
+    public:
+    //////// CONSTRUCTORS
+
+    HashIndex() : count(0), mask(0) {}
+
+    //////// PUBLIC FUNCTIONS
+
+    //Return the item whose identifier equals |key|, or null if there is none
+    T* find(const std::string_view key) const
+    {
+        if (slots.empty()) return nullptr;
+
+        const size_t hash = hashOf(key);
+
+        for (size_t i = hash & mask; slots[i].item; i = (i + 1) & mask)
+        {
+            if (slots[i].hash == hash && std::string_view(slots[i].item->_identifier()) == key) return slots[i].item;
+        }
+
+        return nullptr;
+    }
+
+    //Index |item| by its identifier, replacing any item indexed by the same identifier
+    void insert(T* item)
+    {
+        if ((count + 1) * 2 > slots.size()) rehash(std::max(INDEX_FIRST_CAPACITY, slots.size() * 2));
+
+        const std::string_view key(item->_identifier());
+        const size_t hash = hashOf(key);
+        size_t i = hash & mask;
+
+        while (slots[i].item)
+        {
+            if (slots[i].hash == hash && std::string_view(slots[i].item->_identifier()) == key)
+            {
+                slots[i].item = item;
+                return;
+            }
+
+            i = (i + 1) & mask;
+        }
+
+        slots[i] = Slot{hash, item};
+        ++count;
+    }
+
+    //Remove the item whose identifier equals |key| from the index, the item itself is untouched
+    //Return false if there is none
+    bool erase(const std::string_view key)
+    {
+        if (slots.empty()) return false;
+
+        const size_t hash = hashOf(key);
+        size_t hole = hash & mask;
+
+        while (slots[hole].item &&
+               !(slots[hole].hash == hash && std::string_view(slots[hole].item->_identifier()) == key))
+            hole = (hole + 1) & mask;
+
+        if (!slots[hole].item) return false;
+
+        //An entry further along the run moves back into the hole unless its home slot lies between the hole and it
+        for (size_t i = (hole + 1) & mask; slots[i].item; i = (i + 1) & mask)
+        {
+            const size_t home = slots[i].hash & mask;
+
+            if (((i - home) & mask) >= ((i - hole) & mask))
+            {
+                slots[hole] = slots[i];
+                hole = i;
+            }
+        }
+
+        slots[hole] = Slot{0, nullptr};
+        --count;
+        return true;
+    }
+
+    //Make room for |items| items in total without growing again
+    void reserve(const size_t items)
+    {
+        size_t capacity = INDEX_FIRST_CAPACITY;
+        while (capacity < items * 2) capacity *= 2;
+
+        if (capacity > slots.size()) rehash(capacity);
+    }
+
+    //////// GETTERS
+
+    size_t size() const { return count; }
+
+    private:
+    //An empty slot has a null |item|
+    struct Slot
+    {
+        size_t hash;
+        T* item;
+    };
+
+    //////// DATA
+
+    //A power of two in size, or empty before the first insert
+    std::vector<Slot> slots;
+
+    //The number of items indexed
+    size_t count;
+
+    //One less than the number of slots, the home slot of a hash is |hash & mask|
+    size_t mask;
+
+    //////// PRIVATE FUNCTIONS
+
+    static size_t hashOf(const std::string_view key)
+    {
+        return std::hash<std::string_view>()(key);
+    }
+
+    //Move every entry into a new array of |capacity| slots, the stored hashes are reused
+    void rehash(const size_t capacity)
+    {
+        std::vector<Slot> old(capacity, Slot{0, nullptr});
+        old.swap(slots);
+        mask = capacity - 1;
+
+        for (const Slot& slot : old)
+        {
+            if (!slot.item) continue;
+
+            size_t i = slot.hash & mask;
+            while (slots[i].item) i = (i + 1) & mask;
+
+            slots[i] = slot;
+        }
+    }
+};
+
+#endif //INDEX_HPP_
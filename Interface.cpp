@@ -13,8 +13,69 @@ indentifers will display their cooresponding matrices.
 
 CLEAR : Clear the terminal
 
+ISA (Optional Arg - Instruction Set) : Display the instruction set used by the numeric kernels, or force one of scalar,
+sse2, avx2 or avx512 for testing. The set is chosen automatically for the host CPU at startup.
+
+THREADS (Optional Arg - Thread Count) : Display or set the number of threads that large matrix operations are split
+across. Results are identical for any thread count.
+
+STRASSEN (Optional Args) : Enable ("on") or disable ("off") Strassen-Winograd multiplication for large products, set its
+crossover size, or "check" the accuracy of the Strassen-Winograd product of two matrices against the classic product.
+
+DET (Arg - Matrix Identifier) : Display the determinant of a square matrix.
+
+LU (Arg - Matrix Identifier) : Display the LU factorization of a square matrix with partial pivoting, P * A = L * U. The
+factorization is kept with the matrix, so repeated determinants of an unchanged matrix are not computed again.
+
+QR (Arg - Matrix Identifier, Optional Args - Identifiers for Q and R) : Store the Householder QR factorization of a
+matrix, A = Q * R, as two new matrices. Q has orthonormal columns and R is upper triangular, they are named "A_Q" and
+"A_R" unless two identifiers follow.
+
+SOLVE (Args - Matrix Identifiers) : "solve A B" is the solution X of A * X = B, it can be used as an operand anywhere in
+an expression, such as "X = solve A B". Every column of B is solved at once, and the factorization of A is reused.
+
+INV (Arg - Matrix Identifier) : "inv A" is the inverse of A, it can be used as an operand anywhere in an expression,
+such as "B = inv A". Singular and nearly singular matrices are refused with an estimate of their condition number.
+
+TRANS (Arg - Matrix Identifier) : "trans A", or "A'", is the transpose of A, it can be used as an operand anywhere in an
+expression, such as "C = A' * B". Products read a transposed operand in place, and "A = A'" transposes a square matrix
+within its own storage.
+
+POWER (Arg - Integer) : "A ^ k" is the square matrix A raised to the non-negative integer power k, it can be used as an
+operand anywhere in an expression, such as "P = T ^ 100 * x". Powers are computed by repeated squaring, in O(log k)
+matrix products written into buffers that are reused from one product to the next.
+
+SCALARS : A number in an expression scales the term it belongs to, such as "B = 2.5 * A - C * 0.5". The scale is
+applied as the terms are summed, so no matrix is formed for it and no product is computed.
+
+ELEMENTWISE (.* ./) : "A .* B" multiplies, and "A ./ B" divides, every entry of A by the matching entry of B. They bind
+as tightly as "*" and from the left. The products of a sparse matrix are built from its nonzero entries alone.
+
+KRON (Args - Matrix Identifiers) : "kron A B" is the Kronecker product of A and B, in which each entry of A scales a copy
+of B. It can be used as an operand anywhere in an expression, such as "C = kron A B".
+
+EIG (Arg - Matrix Identifier, Optional Arg - "vectors") : Store the eigenvalues of a symmetric matrix A, in ascending
+order, as the column "A_eig". With "vectors", the eigenvectors are stored as the columns of "A_vec" as well. The
+parallel Jacobi method is used, and matrices that are not symmetric are refused.
+
+LSTSQ (Args - Matrix Identifiers) : "lstsq A B" is the least squares solution X of A * X = B, the X that minimizes the
+residual A * X - B, for an A with at least as many rows as columns. It can be used as an operand anywhere in an
+expression, such as "X = lstsq A B", and the QR factorization of A is reused for every right-hand side.
+
+EXACT (Arg - Matrix Identifier, or "det", "inv" or "solve" and their Args) : Display a matrix, its determinant, its
+inverse or the solution of a linear system with exact fractions, such as "exact inv A" or "exact solve A B". Each entry
+is read as the fraction with the smallest denominator that rounds to it, so 0.1 is exactly 1/10. "exact check" solves
+and inverts fixed matrices whose pivots need row swaps against their known exact results. See |Rational.hpp|.
+
+UNDEF (Args - Matrix Identifiers) : Remove each matrix named, such as "undef A B", and release its memory at once. An
+identifier ending with '*' removes every matrix whose identifier begins with the rest of it, so "undef tmp*" removes
+"tmp", "tmp1" and "tmpA". A name that is bound to a matrix exactly as written, '*' and all, is removed on its own.
+
 QUIT : Quit the program, and write all matrices to an external data file
 
+SPARSE MATRICES : Matrices that are mostly zeros are stored sparse automatically when they are defined, calculated or
+read from the data file, and only their nonzero entries are saved. See |Sparse.hpp|.
+
 @Sean Siders
 sean.siders@icloud.com
 */
@@ -22,7 +83,12 @@ sean.siders@icloud.com
 #include "Interface.hpp"
 
 Interface::Interface() : recent(nullptr) {}
-Interface::Interface(const char* filename) : matrixTree(filename), recent(nullptr) {}
+Interface::Interface(const char* filename) : matrixTree(filename), recent(nullptr)
+{
+    //Index every matrix read in from the data file
+    matrixIndex.reserve(matrixTree.size());
+    matrixTree.forEach([this](Matrix& matrix) { matrixIndex.insert(&matrix); });
+}
 
 //Prompt the user for input
 //Branch to different parts of the program based on the input
@@ -44,30 +110,48 @@ bool Interface::run()
     stream >> initialCommand;
 
     //Determine how the program will respond to the initial command from input
-    switch (evaluateCommand(initialCommand))
+    //Every command reports an invalid request by throwing, which is displayed here before the next prompt
+    try
     {
-        case DEFINE : define(stream); break;
+        switch (evaluateCommand(initialCommand))
+        {
+            case DEFINE : define(stream); break;
 
-        case DISPLAY : display(stream); break;
+            case DISPLAY : display(stream); break;
 
-        case CLEAR : clearScreen(); break;
+            case CLEAR : clearScreen(); break;
 
-        case HELP : helpPrompt(); break;
+            case HELP : helpPrompt(); break;
 
-        case QUIT : return false;
+            case ISA : isa(stream); break;
 
-        case OPERATE :
-        {
-            try { operate(initialCommand, stream); }
+            case THREADS : threads(stream); break;
 
-            catch (const ExceptionHandler& ex)
-            {
-                std::cout << ex << "\n\n";
-            }
-            break;
+            case STRASSEN : strassenMode(stream); break;
+
+            case DET : det(stream); break;
+
+            case LU : lu(stream); break;
+
+            case QR : qr(stream); break;
+
+            case EIG : eig(stream); break;
+
+            case EXACT : exact(stream); break;
+
+            case UNDEFINE : undefine(stream); break;
+
+            case QUIT : return false;
+
+            case OPERATE : operate(initialCommand, stream); break;
+
+            default : break;
         }
+    }
 
-        default : break;
+    catch (const ExceptionHandler& ex)
+    {
+        std::cout << ex << "\n\n";
     }
 
     return true;
@@ -88,6 +172,33 @@ Commands Interface::evaluateCommand(const std::string& command)
     //Prompt the user with instructions on using Lina
     if ("help" == command) return HELP;
 
+    //Display or force the kernel instruction set
+    if ("isa" == command) return ISA;
+
+    //Display or set the thread count
+    if ("threads" == command) return THREADS;
+
+    //Configure the Strassen-Winograd mode
+    if ("strassen" == command) return STRASSEN;
+
+    //Determinant of a matrix
+    if ("det" == command) return DET;
+
+    //LU factorization of a matrix
+    if ("lu" == command) return LU;
+
+    //QR factorization of a matrix
+    if ("qr" == command) return QR;
+
+    //Eigenvalues of a symmetric matrix
+    if ("eig" == command) return EIG;
+
+    //Exact rational results
+    if ("exact" == command) return EXACT;
+
+    //Remove matrices
+    if ("undef" == command || "undefine" == command) return UNDEFINE;
+
     //PROGRAM EXIT
     if ("q" == command || "quit" == command) return QUIT;
 
@@ -176,13 +287,15 @@ void Interface::define(std::istringstream& stream)
     }
     else stream >> key;
 
-    //Check that |key| is not a command id within the program
+    //Check that |key| is not a command or function id within the program
     //|OPERATE| is the default return when the input is unique
-    while (evaluateCommand(key) != OPERATE)
+    while (reservedIdentifier(key))
     {
-        std::cout << '\"' << key << "\" is not available to be a matrix id, this is a Lina command id\n"
+        std::cout << '\"' << key << "\" is not available to be a matrix id, this is a Lina command id, a number or ends "
+        << "with \'\n"
         << "Lina command ids\n"
-        << "clear, def, define, disp, display, help, q, quit\n"
+        << "clear, def, define, det, disp, display, eig, exact, help, inv, isa, kron, lstsq, lu, q, qr, quit, solve,\n"
+        << "strassen, threads, trans, undef, undefine\n"
         << "Please choose another id > ";
 
         getline(std::cin, key, '\n');
@@ -198,7 +311,11 @@ void Interface::define(std::istringstream& stream)
 
         if (getMatrixInput(key, matrixString, rows, columns))
         {
-            recent = matrixTree.insert(Matrix(key, matrixString, rows, columns));
+            //Mostly zero matrices are stored sparse
+            Matrix defined(key, matrixString, rows, columns);
+            defined.adaptStorage();
+
+            recent = bind(std::move(defined));
             
             if (recent) std::cout << "\n\n\"" << key << "\" defined\n\n";
         }
@@ -219,18 +336,403 @@ void Interface::display(std::istringstream& stream) const
 
         while (stream >> key)
         {
-            retrieved = matrixTree.retrieve<std::string>(key);
+            retrieved = lookup(key);
             if (retrieved) std::cout << *retrieved << '\n';
         }
     }
 }
 
+//Remove each matrix named in |stream| and release its memory, an identifier ending with '*' removes every matrix whose
+//identifier begins with what precedes the '*'
+void Interface::undefine(std::istringstream& stream)
+{
+    std::string key;
+    bool any = false;
+
+    while (stream >> key)
+    {
+        any = true;
+
+        //A matrix bound to |key| exactly, even one ending with '*', is removed before |key| is read as a prefix
+        if (unbind(key)) std::cout << "The matrix \"" << key << "\" was removed\n";
+
+        else if ('*' == key.back())
+        {
+            const std::string prefix = key.substr(0, key.size() - 1);
+
+            //Every identifier that begins with |prefix| follows the first one not less than it in order
+            const size_t removed = matrixTree.removeFrom(prefix, [this, &prefix](const Matrix& matrix)
+            {
+                if (0 != matrix._identifier().compare(0, prefix.size(), prefix)) return false;
+
+                //The tree removes |matrix| once this returns true
+                matrixIndex.erase(matrix._identifier());
+                return true;
+            });
+
+            std::cout << removed << (1 == removed ? " matrix" : " matrices") << " removed by \"" << key << "\"\n";
+        }
+
+        else std::cout << '\"' << key << "\" is not bound to a matrix\n";
+    }
+
+    if (!any) throw ExceptionHandler("INVALID COMMAND : 1 or more matrix identifiers must follow \"undef\"");
+
+    //|recent| may point to a matrix that was removed
+    recent = nullptr;
+    std::cout << '\n';
+}
+
 //Print 100 newline characters
 void Interface::clearScreen() const
 {
     for (size_t i = 0; i < 100; ++i) std::cout << '\n';
 }
 
+//Display the instruction set the numeric kernels use
+//If an instruction set name follows in |stream|, force the kernels to that set
+void Interface::isa(std::istringstream& stream) const
+{
+    std::string name;
+
+    if (stream >> name)
+    {
+        Isa requested = ISA_SCALAR;
+
+        if (!parseIsa(name, requested))
+            std::cout << '\"' << name << "\" is not an instruction set : scalar, sse2, avx2, avx512\n";
+
+        else if (!forceIsa(requested))
+            std::cout << "This CPU does not support \"" << name << "\"\n";
+    }
+
+    std::cout << "Instruction set : " << kernels().name << "\n\n";
+}
+
+//Display the number of threads matrix operations run on
+//If a count follows in |stream|, resize the thread pool to that count
+void Interface::threads(std::istringstream& stream) const
+{
+    std::string countString;
+
+    if (stream >> countString)
+    {
+        bool valid = !countString.empty() && countString.size() < 5;
+        for (const char c : countString) valid = valid && std::isdigit(c);
+
+        const size_t count = valid ? std::stoul(countString) : 0;
+
+        if (count) threadPool().resize(count);
+        else std::cout << "INVALID THREAD COUNT : enter a whole number from 1 to 9999\n";
+    }
+
+    std::cout << "Threads : " << threadPool().size() << "\n\n";
+}
+
+//Display the Strassen-Winograd settings after applying the argument in |stream|, which may be :
+//  "on" / "off" : enable or disable the mode
+//  N : set the crossover size
+//  "check" id1 id2 : compare the Strassen-Winograd product of two matrices against the classic product
+void Interface::strassenMode(std::istringstream& stream) const
+{
+    StrassenSettings& settings = strassenSettings();
+    std::string argument;
+
+    if (stream >> argument)
+    {
+        if ("on" == argument) settings.enabled = true;
+
+        else if ("off" == argument) settings.enabled = false;
+
+        else if ("check" == argument)
+        {
+            std::string lhsKey;
+            std::string rhsKey;
+            stream >> lhsKey >> rhsKey;
+
+            const Matrix* lhs = operand(lhsKey);
+            const Matrix* rhs = operand(rhsKey);
+
+            if (!lhs->multiplyCheck(rhs))
+                throw InvalidOperation(lhs, '*', rhs,
+                "The degree of columns in left matrix must match the degree of rows in the right matrix for multiplication");
+
+            //Strassen-Winograd only applies to dense matrices, sparse operands are compared as dense copies
+            Matrix lhsScratch;
+            Matrix rhsScratch;
+            lhs = &lhs->dense(lhsScratch);
+            rhs = &rhs->dense(rhsScratch);
+
+            const StrassenReport report = strassenAccuracy(lhs->_rows(), rhs->_columns(), lhs->_columns(),
+                                                           lhs->_buffer(), lhs->_stride(), rhs->_buffer(), rhs->_stride());
+
+            std::cout << "STRASSEN-WINOGRAD ACCURACY : \"" << lhsKey << "\" * \"" << rhsKey << "\"\n"
+            << "Recursion levels : " << report.levels << '\n'
+            << "Max entry error : " << report.maxError << '\n'
+            << "Relative error (Frobenius) : " << report.relativeError << '\n'
+            << "Classic time : " << report.classicSeconds << " s\n"
+            << "Strassen-Winograd time : " << report.strassenSeconds << " s\n";
+        }
+
+        else
+        {
+            bool valid = !argument.empty() && argument.size() < 10;
+            for (const char c : argument) valid = valid && std::isdigit(c);
+
+            const size_t crossover = valid ? std::stoul(argument) : 0;
+
+            if (crossover < STRASSEN_MIN_CROSSOVER)
+                throw ExceptionHandler("INVALID STRASSEN ARGUMENT : enter \"on\", \"off\", \"check\" id1 id2, "
+                                       "or a crossover of at least " + std::to_string(STRASSEN_MIN_CROSSOVER));
+
+            settings.crossover = crossover;
+        }
+    }
+
+    std::cout << "Strassen-Winograd : " << (settings.enabled ? "on" : "off")
+    << " (crossover " << settings.crossover << ")\n\n";
+}
+
+//Display the determinant of the matrix named in |stream|
+void Interface::det(std::istringstream& stream) const
+{
+    const Matrix* source = squareOperand(stream, "det");
+
+    std::cout << "det ";
+    source->displayIdentifier();
+    std::cout << " = " << source->factorization().determinant() << "\n\n";
+}
+
+//Display the L, U and P factors of the matrix named in |stream|, where P * A = L * U
+void Interface::lu(std::istringstream& stream) const
+{
+    const Matrix* source = squareOperand(stream, "lu");
+    const LuFactorization& factors = source->factorization();
+
+    const size_t order = factors._order();
+    const double* combined = factors._factors();
+    const size_t* pivots = factors._pivots();
+
+    //Split the combined factors, L has a unit diagonal
+    std::vector<double> lower(order * order, 0.0);
+    std::vector<double> upper(order * order, 0.0);
+
+    for (size_t r = 0; r < order; ++r)
+    {
+        for (size_t c = 0; c < order; ++c)
+        {
+            if (c < r) lower[r * order + c] = combined[r * order + c];
+            else upper[r * order + c] = combined[r * order + c];
+        }
+
+        lower[r * order + r] = 1.0;
+    }
+
+    //Replay the row swaps on the rows of the identity
+    std::vector<size_t> rowOf(order);
+    for (size_t r = 0; r < order; ++r) rowOf[r] = r;
+    for (size_t r = 0; r < order; ++r) std::swap(rowOf[r], rowOf[pivots[r]]);
+
+    std::vector<double> permutation(order * order, 0.0);
+    for (size_t r = 0; r < order; ++r) permutation[r * order + rowOf[r]] = 1.0;
+
+    std::cout << "P * ";
+    source->displayIdentifier();
+    std::cout << " = L * U" << (factors.singular() ? " (singular)" : "") << "\n\n"
+    << Matrix("L", lower.data(), order, order, order) << '\n'
+    << Matrix("U", upper.data(), order, order, order) << '\n'
+    << Matrix("P", permutation.data(), order, order, order) << '\n';
+}
+
+//Store the factors Q and R of the matrix named in |stream|, where A = Q * R
+//They are named after the two identifiers that follow, or after the matrix with "_Q" and "_R" appended
+void Interface::qr(std::istringstream& stream)
+{
+    const Matrix* source = nextOperand(stream, "qr");
+
+    std::string qKey = source->_identifier() + "_Q";
+    std::string rKey = source->_identifier() + "_R";
+
+    std::string key;
+    if (stream >> key)
+    {
+        qKey = key;
+        if (!(stream >> rKey)) throw ExceptionHandler("INVALID COMMAND : an identifier for R must follow \"" + qKey + '\"');
+    }
+
+    if (reservedIdentifier(qKey) || reservedIdentifier(rKey) || qKey == rKey)
+        throw ExceptionHandler("INVALID IDENTIFIER : Q and R need two distinct identifiers that are not Lina command ids");
+
+    //Both factors are formed before either is stored, storing Q may replace the source matrix itself
+    Matrix Q = source->orthogonalFactor(qKey);
+    Matrix R = source->triangularFactor(rKey);
+
+    std::cout << "QR FACTORIZATION : ";
+    source->displayIdentifier();
+    std::cout << " = " << qKey << " * " << rKey << "\n\n";
+
+    store(qKey, std::move(Q));
+    store(rKey, std::move(R));
+    std::cout << '\n';
+}
+
+//Store the eigenvalues of the symmetric matrix named in |stream| as a column named after the matrix with "_eig"
+//appended, and its eigenvectors as the columns of a matrix with "_vec" appended if "vectors" follows
+//Will throw an exception if the matrix is not square or not symmetric
+void Interface::eig(std::istringstream& stream)
+{
+    const Matrix* source = squareOperand(stream, "eig");
+
+    std::string option;
+    const bool withVectors = static_cast<bool>(stream >> option);
+
+    if (withVectors && "vectors" != option)
+        throw ExceptionHandler("INVALID EIG ARGUMENT : only \"vectors\" may follow the matrix identifier");
+
+    //The solver works on dense entries, a sparse matrix is expanded into a copy
+    Matrix scratch;
+    const Matrix* entries = &source->dense(scratch);
+    const size_t order = entries->_rows();
+
+    if (!symmetric(order, entries->_buffer(), entries->_stride()))
+        throw InvalidOperation("eig", source, "The matrix must be symmetric, A(i, j) must equal A(j, i)");
+
+    const SymmetricEigen eigen(order, entries->_buffer(), entries->_stride(), withVectors);
+    const std::string valuesKey = source->_identifier() + "_eig";
+    const std::string vectorsKey = source->_identifier() + "_vec";
+
+    //Both results are formed before either is stored, storing them may replace the source matrix itself
+    Matrix values(valuesKey, eigen._values(), order, 1, 1);
+    Matrix vectors;
+    if (withVectors) vectors = Matrix(vectorsKey, eigen._vectors(), order, order, order);
+
+    std::cout << "EIGENVALUES : ";
+    source->displayIdentifier();
+    std::cout << ", " << eigen._sweeps() << " Jacobi sweeps" << (eigen._converged() ? "" : " (not converged)") << "\n\n";
+
+    store(valuesKey, std::move(values));
+    if (withVectors) store(vectorsKey, std::move(vectors));
+    std::cout << '\n';
+}
+
+//Display the matrix named in |stream| with its entries as exact fractions, or when "det", "inv" or "solve" comes first,
+//the exact determinant, inverse or solution of a linear system
+//"check" solves and inverts fixed matrices that need row swaps, and displays any case that is not exact
+//Will throw an exception if an entry is not finite, a matrix is not square where it must be, or is singular
+void Interface::exact(std::istringstream& stream) const
+{
+    std::string word;
+    if (!(stream >> word))
+        throw ExceptionHandler("INVALID COMMAND : a matrix identifier, or det, inv, solve or check must follow \"exact\"");
+
+    if ("det" == word)
+    {
+        const Matrix* source = squareOperand(stream, "exact det");
+        const Fraction determinant = rational(source, "exact det").determinant();
+
+        std::cout << "det ";
+        source->displayIdentifier();
+        std::cout << " = " << determinant.text() << "\n\n";
+    }
+    else if ("inv" == word)
+    {
+        const Matrix* source = squareOperand(stream, "exact inv");
+        RationalMatrix inverse(0, 0);
+
+        if (!rational(source, "exact inv").inverse(inverse))
+            throw InvalidOperation("exact inv", source, "The matrix is singular, it has no inverse");
+
+        std::cout << "inv ";
+        source->displayIdentifier();
+        std::cout << " (exact)\n" << inverse << '\n';
+    }
+    else if ("solve" == word)
+    {
+        const Matrix* lhs = squareOperand(stream, "exact solve");
+        const Matrix* rhs = nextOperand(stream, "exact solve");
+
+        if (lhs->_rows() != rhs->_rows())
+            throw InvalidOperation(lhs, '\\', rhs,
+            "The degree of rows in the right-hand side must match the order of the matrix");
+
+        RationalMatrix solution(0, 0);
+
+        if (!rational(lhs, "exact solve").solve(rational(rhs, "exact solve"), solution))
+            throw InvalidOperation("exact solve", lhs, "The matrix is singular, the system has no unique solution");
+
+        std::cout << "solve ";
+        lhs->displayIdentifier();
+        std::cout << ' ';
+        rhs->displayIdentifier();
+        std::cout << " (exact)\n" << solution << '\n';
+    }
+    else if ("check" == word)
+    {
+        const std::vector<std::string> failed = RationalMatrix::check();
+
+        std::cout << "EXACT CHECK : " << (failed.empty() ? "every case passed" : "failed") << '\n';
+        for (const std::string& name : failed) std::cout << "  " << name << '\n';
+        std::cout << '\n';
+    }
+    else
+    {
+        const Matrix* source = operand(word);
+
+        source->displayIdentifier();
+        std::cout << " (exact)\n" << rational(source, "exact") << '\n';
+    }
+}
+
+//Return the entries of |source| as exact fractions
+//Will throw an exception for |function| if an entry is not finite
+RationalMatrix Interface::rational(const Matrix* source, const std::string& function)
+{
+    //The conversion reads dense entries, a sparse matrix is expanded into a copy
+    Matrix scratch;
+    const Matrix* entries = &source->dense(scratch);
+    const double* buffer = entries->_buffer();
+    const size_t stride = entries->_stride();
+
+    for (size_t r = 0; r < entries->_rows(); ++r)
+    {
+        for (size_t c = 0; c < entries->_columns(); ++c)
+            if (!std::isfinite(buffer[r * stride + c]))
+                throw InvalidOperation(function, source, "Every entry must be finite to be read as a fraction");
+    }
+
+    return RationalMatrix(entries->_rows(), entries->_columns(), buffer, stride);
+}
+
+//Bind |result| to |key|, if |key| is already bound the user decides whether to overwrite
+//Only the identifier and order are displayed, the matrix may be far too large to print
+void Interface::store(const std::string& key, Matrix&& result)
+{
+    Matrix* stored = lookup(key);
+
+    if (stored)
+    {
+        std::cout << "The identifier \"" << key << '\"' << " is already assigned to a matrix\n"
+        << "would you like to overwrite?";
+
+        if (!getYesNo())
+        {
+            std::cout << "\nThe matrix \"" << key << "\" was not overwritten\n";
+            return;
+        }
+
+        stored->overwrite(std::move(result), key);
+        stored->adaptStorage();
+        std::cout << "\nThe matrix \"" << key << "\" was overwritten : " << stored->_rows() << " x " << stored->_columns()
+        << '\n';
+        return;
+    }
+
+    stored = bind(Matrix(std::move(result), key));
+    stored->adaptStorage();
+    std::cout << "NEW MATRIX DEFINED BY CALCULATION : \"" << key << "\" " << stored->_rows() << " x "
+    << stored->_columns() << '\n';
+}
+
 void Interface::helpPrompt() const
 {
     //Prompt the user with instructions on how to use Lina
@@ -239,6 +741,16 @@ void Interface::helpPrompt() const
     << "\"define\" OR \"def\" (*optional arg) -- define a new matrix with a unique *id\n"
     << "\"display\" OR \"disp\" (*optional arg(s)) -- display all matrices or the provided *id(s) separated by a single space\n"
     << "\"clear\" -- clear the terminal\n"
+    << "\"isa\" (*optional arg) -- display the kernel instruction set, or force *scalar, sse2, avx2 or avx512\n"
+    << "\"threads\" (*optional arg) -- display the thread count, or set it to *N\n"
+    << "\"strassen\" (*optional args) -- *on, *off, set the crossover to *N, or *check id1 id2 accuracy\n"
+    << "\"det\" id -- display the determinant of a square matrix\n"
+    << "\"lu\" id -- display the factors L, U and P of a square matrix, where P * id = L * U\n"
+    << "\"qr\" id (*optional args) -- store the factors Q and R of id as id_Q and id_R, or as *idQ *idR\n"
+    << "\"eig\" id (*optional arg) -- store the eigenvalues of a symmetric matrix as id_eig, and with *vectors as id_vec\n"
+    << "\"exact\" id OR \"exact\" det id OR inv id OR solve id1 id2 -- display the result with exact fractions\n"
+    << "\"exact check\" -- check exact inverses and solutions against known results\n"
+    << "\"undef\" id(s) OR prefix* -- remove matrices and free their memory, prefix* removes ids beginning with prefix\n"
     << "\"help\" (*optional arg) -- display this prompt\n"
     << "\"quit\" OR \"q\" -- terminate the program, saving all defined matrices\n\n"
 
@@ -250,7 +762,51 @@ void Interface::helpPrompt() const
 
     << "Multiplication (Dot Product)\n"
     << "id1 * id2\n"
-    << "- The magnitude of columns in the left operand must equal the magnitude of rows in the right operand\n\n";
+    << "- The magnitude of columns in the left operand must equal the magnitude of rows in the right operand\n\n"
+
+    << "SCALING\n"
+    << "2.5 * id OR id * 2.5 OR 2 * id1 - 0.5 * id2 ...\n"
+    << "- A number scales every entry of the term it is in, a scaled sum is still computed in a single pass\n\n"
+
+    << "ELEMENTWISE MULTIPLICATION AND DIVISION\n"
+    << "id1 .* id2 OR id1 ./ id2 OR id ./ 2\n"
+    << "- Both matrices must be of the same order, each entry of id1 is multiplied or divided by the entry of id2\n\n"
+
+    << "KRONECKER PRODUCT\n"
+    << "kron id1 id2 OR newId = kron id1 id2\n"
+    << "- Each entry of id1 scales a copy of id2, an m x n id1 and p x q id2 give an mp x nq matrix\n\n"
+
+    << "POWERS\n"
+    << "id ^ k OR newId = id ^ k\n"
+    << "- id must be square and k a non-negative integer, id ^ 0 is the identity\n"
+    << "- Powers are computed before products, by repeated squaring in O(log k) multiplications\n\n"
+
+    << "LINEAR SYSTEMS\n"
+    << "solve id1 id2 OR newId = solve id1 id2\n"
+    << "- The solution X of id1 * X = id2, every column of id2 is a right-hand side\n"
+    << "- id1 must be square, its factorization is reused for every right-hand side it is solved against\n\n"
+
+    << "LEAST SQUARES\n"
+    << "lstsq id1 id2 OR newId = lstsq id1 id2\n"
+    << "- The X that minimizes the residual id1 * X - id2, every column of id2 is a right-hand side\n"
+    << "- id1 must have at least as many rows as columns and full column rank\n\n"
+
+    << "INVERSE\n"
+    << "inv id OR newId = inv id\n"
+    << "- id must be square and not singular or nearly singular\n\n"
+
+    << "TRANSPOSE\n"
+    << "id' OR trans id OR newId = id'\n"
+    << "- A transposed operand is read in place by products, such as id1' * id2\n"
+    << "- id = id' transposes a square matrix within its own storage\n\n"
+
+    << "CHAINS AND ASSIGNMENT\n"
+    << "id1 * id2 + id3 - id4 ... OR newId = id1 * id2 + id3 - id4 ...\n"
+    << "- Products are computed before sums, a chain of sums is computed in a single pass\n"
+    << "- A chain of products is grouped to take the fewest operations, (id1 * id2) * id3 or id1 * (id2 * id3)\n\n"
+
+    << "SPARSE MATRICES\n"
+    << "- Large matrices that are mostly zeros are stored and computed sparse automatically\n\n";
 }
 
 //If the user is attempting an operation |lhsKey| will be:
@@ -260,70 +816,42 @@ void Interface::helpPrompt() const
 //      * The resulting matrix will just be displayed and not assigned an identifier or stored in the |matrixTree|
 void Interface::operate(const std::string& lhsKey, std::istringstream& stream)
 {
-    //To store the operator read in from |stream|
+    //Look ahead for an assignment operator
+    const std::streampos start = stream.tellg();
     std::string op;
-
-    //To store the right operand identifier read in from |stream|
-    std::string rhsKey;
-
-    //Attempt to read in an operator from |stream|
     stream >> op;
 
-    //Attempt to read in the right operand from |stream|
-    stream >> rhsKey;
-
-    //Attempt |lhs| retrieval on first call
-    //For any following call |lhs| will be the |result| of the previous operation
-    //|lhs| may or may not be an existing matrix
-    Matrix* lhs = matrixTree.retrieve<std::string>(lhsKey);
-
-    //Attempt |rhs| retrieval
-    //|rhs| must be an existing matrix
-    Matrix* rhs = matrixTree.retrieve<std::string>(rhsKey);
-    if (!rhs) throw ExceptionHandler("INVALID COMMAND : enter \"help\" for all valid commands");
-
-    //Evaluate the operater read in, if it is valid, attempt the operation
-    switch(evaluateOperator(op))
+    if (ASSIGN == evaluateOperator(op))
     {
-        case INVALID_OP : throw ExceptionHandler("INVALID OPERATOR : enter \"help\" for all valid commands");
-
-        case PLUS : add(lhs, rhs, true); break;
-
-        case MINUS : add(lhs, rhs, false); break;
-
-        case MULTIPLY : multiply(lhs, rhs); break;
-
-        case ASSIGN : assign(lhs, lhsKey, rhs, stream); break;
+        if (reservedIdentifier(lhsKey))
+        {
+            throw ExceptionHandler("INVALID IDENTIFIER : \"" + lhsKey + "\" is a Lina function id, a number or ends "
+                                   "with \', choose another id");
+        }
 
-        default : return;
+        assign(lhsKey, stream);
+        return;
     }
-}
 
-//Returns the resulting matrix, used in |assign|
-void Interface::operate(const Matrix* lhs, const Operators op, const Matrix* rhs, Matrix*& result, const std::string& resultKey)
-{
-    switch(op)
+    //|lhsKey| is the left operand, it must be an existing matrix, a function or a number
+    const std::string firstName = lhsKey.substr(0, lhsKey.size() - transposeMarks(lhsKey));
+    double value = 0.0;
+
+    if (NO_FUNCTION == evaluateFunction(firstName) && !lookup(firstName) &&
+        !scalarLiteral(lhsKey, value))
     {
-        case PLUS :
-        {
-            if (result) result->overwrite((*lhs) + (*rhs), resultKey);
-            else result = new Matrix((*lhs) + (*rhs), resultKey);
-        }
+        throw ExceptionHandler("INVALID COMMAND : enter \"help\" for all valid commands");
+    }
 
-        case MINUS :
-        {
-            if (result) result->overwrite((*lhs) + (*rhs), resultKey);
-            else result = new Matrix((*lhs) + (*rhs), resultKey);
-        }
+    //Rewind so the operator is parsed as part of the expression
+    stream.clear();
+    stream.seekg(start);
 
-        case MULTIPLY :
-        {
-            if (result) result->overwrite((*lhs) + (*rhs), resultKey);
-            else result = new Matrix((*lhs) + (*rhs), resultKey);
-        }
+    std::vector<Term> terms;
+    std::deque<Matrix> computed;
+    parseExpression(lhsKey, stream, terms, computed);
 
-        default : break;
-    }
+    std::cout << evaluateExpression(terms);
 }
 
 //Evaluate which operator the user input, then return the cooresponding enum
@@ -338,6 +866,15 @@ Operators Interface::evaluateOperator(const std::string& operatorString) const
     //Attempt matrix multiplication
     if ("*" == operatorString) return MULTIPLY;
 
+    //Attempt raising a matrix to a power
+    if ("^" == operatorString) return POWER;
+
+    //Attempt elementwise multiplication
+    if (".*" == operatorString) return HADAMARD;
+
+    //Attempt elementwise division
+    if ("./" == operatorString) return QUOTIENT;
+
     //Attempt matrix assignment to the following operation
     if ("=" == operatorString) return ASSIGN;
     
@@ -345,52 +882,276 @@ Operators Interface::evaluateOperator(const std::string& operatorString) const
     return INVALID_OP;
 }
 
-//Attempt to add two matrices |lhs| and |rhs|
-//If |positive| is false, |rhs| will be subracted from |lhs|
-//If the matrices are not of the same order, addition cannot occur, an exception is thrown
-void Interface::add(const Matrix* lhs, const Matrix* rhs, const bool positive)
+//Evaluate which function |name| refers to, return |NO_FUNCTION| if it is not a function
+Functions Interface::evaluateFunction(const std::string& name)
 {
-    //If |lhs| and |rhs| are not of the same order
-    if (!lhs || !lhs->orderMatch(rhs))
-        throw InvalidOperation(lhs, (positive ? '+' : '-'), rhs, "Matrices must be of the same order for addition / subtraction");
+    //Solve a linear system
+    if ("solve" == name) return SOLVE;
+
+    //Invert a matrix
+    if ("inv" == name) return INVERSE;
+
+    //Transpose a matrix
+    if ("trans" == name) return TRANSPOSE;
+
+    //Fit an overdetermined system
+    if ("lstsq" == name) return LEAST_SQUARES;
 
-    std::cout << (positive ? ((*lhs) + (*rhs)) : ((*lhs) - (*rhs)));
+    //Form a Kronecker product
+    if ("kron" == name) return KRONECKER;
+
+    return NO_FUNCTION;
 }
 
-//Attempt to multiple two matrices |lhs| and |rhs|
-//If the columns of |lhs| do not match the rows of |rhs|, multiplication cannot occur
-void Interface::multiply(const Matrix* lhs, const Matrix* rhs)
+//True if |key| may not name a matrix : it is a command or function id, a number, or ends with "'"
+bool Interface::reservedIdentifier(const std::string& key)
 {
-    if (!lhs || !lhs->multiplyCheck(rhs))
-        throw InvalidOperation(lhs, '*', rhs,
-        "The degree of columns in left matrix must match the degree of rows in the right matrix for multiplication");
+    double value = 0.0;
 
-    std::cout << ((*lhs) * (*rhs));
+    return evaluateCommand(key) != OPERATE || evaluateFunction(key) != NO_FUNCTION || transposeMarks(key) ||
+           scalarLiteral(key, value);
 }
 
-//Attempt to do a matrix operation with |lhs| and the |rhs| which is yet to be read in from |stream|
-//If |result| is already allocated, the user will have to decide if they want to overwrite
-//If the operation is successful store the resulting matrix in |result|
-void Interface::assign(Matrix*& result, const std::string& resultKey, const Matrix* lhs, std::istringstream& stream)
+//True if |key| is a number, such as 2.5, -3 or 1e-6, which is then written into |value|
+//A number begins with a digit, a sign or a point, so names such as "inf" remain identifiers
+bool Interface::scalarLiteral(const std::string& key, double& value)
 {
-    if (!lhs) throw ExceptionHandler("ASSIGNMENT FAILED : the left operand identifier was not found");
+    if (key.empty() || !(std::isdigit(key[0]) || '-' == key[0] || '+' == key[0] || '.' == key[0])) return false;
+
+    char* end = nullptr;
+    value = std::strtod(key.c_str(), &end);
+
+    return end == key.c_str() + key.size();
+}
+
+//Parse the expression that begins with the operand |firstKey| and continues in |stream| into |terms|
+//Functions are computed as they are parsed, their results are held in |computed|
+//Will throw an exception if :
+//  - An operator is invalid
+//  - An operand identifier does not exist
+//  - The orders of the operands do not allow the operation
+void Interface::parseExpression(const std::string& firstKey, std::istringstream& stream, std::vector<Term>& terms,
+                                std::deque<Matrix>& computed) const
+{
+    terms.push_back(Term{{}, false, 1.0});
+    extendTerm(terms.back(), MULTIPLY, firstKey, stream, computed);
 
-    //To store the operator read in from |stream|
     std::string op;
+    std::string key;
 
-    //To store the identifier for the |rhs| matrix read in from |stream|
-    std::string rhsKey;
+    while (stream >> op)
+    {
+        Operators eOP = evaluateOperator(op);
 
-    stream >> op;
-    Operators eOP = evaluateOperator(op);
+        if (INVALID_OP == eOP || ASSIGN == eOP)
+            throw ExceptionHandler("INVALID OPERATOR : enter \"help\" for all valid commands");
 
-    //Invalid operator input cases
-    if (eOP == INVALID_OP || eOP == ASSIGN) throw ExceptionHandler("ASSIGNMENT FAILED : operator invalid");
+        //Every power of a matrix was taken as its operand was read
+        if (POWER == eOP) throw ExceptionHandler("INVALID EXPRESSION : only a matrix can be raised to a power, id ^ k");
 
-    stream >> rhsKey;
+        if (!(stream >> key)) throw ExceptionHandler("INVALID COMMAND : an operand must follow \"" + op + '\"');
 
-    const Matrix* rhs = matrixTree.retrieve<std::string>(rhsKey);
-    if (!rhs) throw ExceptionHandler("ASSIGNMENT FAILED : the right operand identifier was not found");
+        //Begin a new term
+        if (PLUS == eOP || MINUS == eOP)
+        {
+            terms.push_back(Term{{}, MINUS == eOP, 1.0});
+            eOP = MULTIPLY;
+        }
+
+        extendTerm(terms.back(), eOP, key, stream, computed);
+    }
+
+    //A term of numbers alone has no order to add to the others
+    for (const Term& term : terms)
+    {
+        if (term.factors.empty())
+            throw ExceptionHandler("INVALID EXPRESSION : a number must multiply a matrix, such as 2.5 * id");
+    }
+
+    //Every term must be of the same order as the first
+    //The order of a term is the rows of its first factor by the columns of its last factor
+    const Term& first = terms.front();
+
+    for (size_t i = 1; i < terms.size(); ++i)
+    {
+        const Term& term = terms[i];
+
+        if (first.factors.front()._rows() != term.factors.front()._rows() ||
+            first.factors.back()._columns() != term.factors.back()._columns())
+        {
+            throw InvalidOperation(first.factors.front().matrix, (term.negate ? '-' : '+'), term.factors.front().matrix,
+            "Matrices must be of the same order for addition / subtraction");
+        }
+    }
+}
+
+//Return the matrix resulting from the parsed |terms|
+//Products bind tighter than sums, the sum of every term is fused into a single pass over memory
+//The result is returned by value and moved onward, its buffer is allocated exactly once
+Matrix Interface::evaluateExpression(const std::vector<Term>& terms)
+{
+    //A single product or transpose needs no sum, it is returned as computed and scaled in place
+    if (1 == terms.size() && (terms.front().factors.size() > 1 || terms.front().factors.front().transposed))
+    {
+        Matrix result = product(terms.front().factors);
+        if (1.0 != terms.front().scale) result *= terms.front().scale;
+
+        return result;
+    }
+
+    //Only terms that are products or transposes need their own matrix, every other term is read in place
+    //Dense terms are scaled as they are summed, a scaled sparse term is scaled in a matrix of its own beforehand
+    std::vector<Matrix> products;
+    products.reserve(terms.size());
+
+    std::vector<const Matrix*> operands;
+
+    for (const Term& term : terms)
+    {
+        const Factor& first = term.factors.front();
+
+        if (1 == term.factors.size() && !first.transposed && !(first.matrix->_sparse() && 1.0 != term.scale))
+        {
+            operands.push_back(first.matrix);
+            continue;
+        }
+
+        products.push_back(product(term.factors));
+        if (products.back()._sparse() && 1.0 != term.scale) products.back() *= term.scale;
+
+        operands.push_back(&products.back());
+    }
+
+    //Dense operands are fused into a single pass, sparse operands then add only their nonzero entries
+    size_t firstDense = 0;
+    while (firstDense < operands.size() && operands[firstDense]->_sparse()) ++firstDense;
+
+    const bool allSparse = (firstDense == operands.size());
+    Matrix result;
+
+    //Every operand is sparse, the sum is built sparse
+    if (allSparse) result = *operands.front();
+
+    else
+    {
+        Chain chain(*operands[firstDense], terms[firstDense].negate, terms[firstDense].scale);
+
+        for (size_t i = firstDense + 1; i < operands.size(); ++i)
+        {
+            if (!operands[i]->_sparse()) chain.append(*operands[i], terms[i].negate, terms[i].scale);
+        }
+
+        //The result is named after the leftmost operand, as for a dense chain
+        result = Matrix(Matrix(chain), operands.front()->_identifier());
+    }
+
+    for (size_t i = (allSparse ? 1 : 0); i < operands.size(); ++i)
+    {
+        if (!operands[i]->_sparse()) continue;
+
+        if (terms[i].negate) result -= *operands[i];
+        else result += *operands[i];
+    }
+
+    return result;
+}
+
+//Return the product of |factors|, multiplied in the order that takes the fewest floating point operations
+//Products are associative, so a chain of tall and wide factors may be grouped to keep every intermediate small
+//Transposed factors are passed to |Matrix::multiplyTransposed| as views
+Matrix Interface::product(const std::vector<Factor>& factors)
+{
+    const Factor& first = factors.front();
+
+    if (1 == factors.size()) return first.transposed ? first.matrix->transposed() : *first.matrix;
+
+    return chainProduct(factors, chainOrder(factors), 0, factors.size() - 1);
+}
+
+//Return the split of every chain of |factors| in the order that multiplies it with the fewest operations
+//The classic dynamic program : the cheapest order of each chain is found from the cheapest orders of the shorter chains
+//within it, a rows x inner by inner x columns product costing rows * inner * columns multiplications
+//Ties are split as late as possible, so a chain with no cheaper order is still multiplied left to right
+std::vector<size_t> Interface::chainOrder(const std::vector<Factor>& factors)
+{
+    const size_t count = factors.size();
+
+    //The order of the chain, factor i is dimensions[i] x dimensions[i + 1]
+    std::vector<double> dimensions(count + 1);
+    for (size_t i = 0; i < count; ++i) dimensions[i] = static_cast<double>(factors[i]._rows());
+    dimensions[count] = static_cast<double>(factors.back()._columns());
+
+    //The fewest multiplications for the chain of factors i through j, at entry i * |count| + j
+    std::vector<double> costs(count * count, 0.0);
+    std::vector<size_t> splits(count * count, 0);
+
+    for (size_t length = 2; length <= count; ++length)
+    {
+        for (size_t i = 0; i + length <= count; ++i)
+        {
+            const size_t j = i + length - 1;
+            double& best = costs[i * count + j];
+            best = std::numeric_limits<double>::infinity();
+
+            for (size_t k = i; k < j; ++k)
+            {
+                const double cost = costs[i * count + k] + costs[(k + 1) * count + j] +
+                                    dimensions[i] * dimensions[k + 1] * dimensions[j + 1];
+
+                if (cost <= best)
+                {
+                    best = cost;
+                    splits[i * count + j] = k;
+                }
+            }
+        }
+    }
+
+    return splits;
+}
+
+//Return the product of the chain of |factors| |first| through |last|, |first| < |last|, split as |splits| directs
+//A side that is a single factor is read in place, transposed or not, only the products within the chain are formed
+//The result is named after the leftmost factor, as for a product computed left to right
+Matrix Interface::chainProduct(const std::vector<Factor>& factors, const std::vector<size_t>& splits, const size_t first,
+                               const size_t last)
+{
+    const size_t split = splits[first * factors.size() + last];
+
+    Factor lhs = factors[first];
+    Factor rhs = factors[last];
+    Matrix left;
+    Matrix right;
+
+    if (split > first)
+    {
+        left = chainProduct(factors, splits, first, split);
+        lhs = Factor{&left, false};
+    }
+
+    if (last > split + 1)
+    {
+        right = chainProduct(factors, splits, split + 1, last);
+        rhs = Factor{&right, false};
+    }
+
+    return lhs.matrix->multiplyTransposed(*rhs.matrix, lhs.transposed, rhs.transposed);
+}
+
+//Assign the result of the expression in |stream| to |resultKey|
+//If |resultKey| is already bound to a matrix, the user will have to decide if they want to overwrite
+//Will throw an exception if the expression is invalid
+void Interface::assign(const std::string& resultKey, std::istringstream& stream)
+{
+    std::string firstKey;
+    if (!(stream >> firstKey)) throw ExceptionHandler("ASSIGNMENT FAILED : an expression must follow \"=\"");
+
+    //Parse the whole expression before any question is asked, only its functions are computed so far
+    std::vector<Term> terms;
+    std::deque<Matrix> computed;
+    parseExpression(firstKey, stream, terms, computed);
+
+    Matrix* result = lookup(resultKey);
 
     //If |result| is allocated, ask the user if they want to overwrite
     if (result)
@@ -398,30 +1159,357 @@ void Interface::assign(Matrix*& result, const std::string& resultKey, const Matr
         std::cout << "The identifier \"" << resultKey << '\"' << " is already assigned to a matrix\n"
         << "would you like to overwrite?";
 
+        //"A = A'" and "A = 2.5 * A" change A itself, a square A is transposed within its own buffer
+        const Term& only = terms.front();
+        const Factor& first = only.factors.front();
+        const bool inPlace = (1 == terms.size() && 1 == only.factors.size() && first.matrix == result);
+
         if (getYesNo())
         {
-            operate(lhs, eOP, rhs, result, resultKey);
+            if (inPlace)
+            {
+                if (first.transposed) result->transpose();
+                if (1.0 != only.scale) *result *= only.scale;
+            }
+
+            else result->overwrite(evaluateExpression(terms), resultKey);
+
+            result->adaptStorage();
             std::cout << "\nThe matrix \"" << resultKey << "\" was overwritten\n" << *result;
         }
 
         else std::cout << "\nThe matrix \"" << resultKey << "\" was not overwritten\n\n";
     }
 
+    //The result is moved into the tree under |resultKey|, it is never copied
     else
     {
-        operate(lhs, eOP, rhs, result, resultKey);
+        result = bind(Matrix(evaluateExpression(terms), resultKey));
+        result->adaptStorage();
         std::cout << "NEW MATRIX DEFINED BY CALCULATION\n" << *result;
-        matrixTree.insert(*result);
-        delete result; //TODO : remove conditional allocation
     }
 }
 
+//Return the matrix bound to |key|
+//Will throw an exception if |key| is not bound to a matrix
+const Matrix* Interface::operand(const std::string& key) const
+{
+    const Matrix* matrix = lookup(key);
+    if (!matrix) throw ExceptionHandler("UNDEFINED IDENTIFIER : \"" + key + "\" is not bound to a matrix");
+
+    return matrix;
+}
+
+//Extend |term| with the operand |key|, joined to the term so far by |op|, which is |MULTIPLY|, |HADAMARD| or |QUOTIENT|
+//A number only changes the |scale| of the term, it commutes with every matrix operation so it is applied once, as the
+//term is summed
+//An elementwise operator binds as tightly as '*' and from the left, so the product of the term so far is computed and
+//replaced by its elementwise product or quotient with |key|
+//Will throw an exception if :
+//  - The orders of the operands do not allow the operation
+//  - A number divides by 0, or leaves the scale of the term infinite or NaN
+void Interface::extendTerm(Term& term, const Operators op, const std::string& key, std::istringstream& stream,
+                           std::deque<Matrix>& computed) const
+{
+    double value = 0.0;
+
+    if (scalarLiteral(key, value))
+    {
+        if (QUOTIENT == op && 0.0 == value) throw ExceptionHandler("INVALID EXPRESSION : a matrix cannot be divided by 0");
+
+        if (QUOTIENT == op) term.scale /= value;
+        else term.scale *= value;
+
+        //Scaling runs over the padding of every row as well, an infinite or NaN scale would turn that padding into NaN
+        if (!std::isfinite(term.scale))
+            throw ExceptionHandler("INVALID EXPRESSION : a matrix can only be scaled by a finite number");
+
+        return;
+    }
+
+    const Factor rhs = powers(factor(key, stream, computed), stream, computed);
+
+    //Multiplying numbers entry by entry is scaling
+    if (term.factors.empty())
+    {
+        if (QUOTIENT == op)
+            throw ExceptionHandler("INVALID EXPRESSION : a number cannot be divided by a matrix, use id ./ id or id ./ 2");
+
+        term.factors.push_back(rhs);
+        return;
+    }
+
+    const Factor& lhs = term.factors.back();
+
+    if (MULTIPLY == op)
+    {
+        if (lhs._columns() != rhs._rows())
+            throw InvalidOperation(lhs.matrix, '*', rhs.matrix,
+            "The degree of columns in left matrix must match the degree of rows in the right matrix for multiplication");
+
+        term.factors.push_back(rhs);
+        return;
+    }
+
+    if (term.factors.front()._rows() != rhs._rows() || lhs._columns() != rhs._columns())
+    {
+        throw InvalidOperation(lhs.matrix, (QUOTIENT == op ? '/' : '*'), rhs.matrix,
+                               "Matrices must be of the same order for elementwise multiplication / division");
+    }
+
+    //Both sides are read in place unless they are products or transposes
+    const Matrix* left = lhs.matrix;
+    const Matrix* right = rhs.matrix;
+
+    if (term.factors.size() > 1 || lhs.transposed)
+    {
+        computed.push_back(product(term.factors));
+        left = &computed.back();
+    }
+
+    if (rhs.transposed)
+    {
+        computed.push_back(rhs.matrix->transposed());
+        right = &computed.back();
+    }
+
+    computed.push_back(left->hadamard(*right, QUOTIENT == op));
+    term.factors.assign(1, Factor{&computed.back(), false});
+}
+
+//Return |base| raised to every "^ k" that follows in |stream|, leaving any other operator in |stream|
+//Powers bind tighter than every other operator, "A * B ^ 2" raises only B
+Factor Interface::powers(Factor base, std::istringstream& stream, std::deque<Matrix>& computed) const
+{
+    std::string op;
+    std::string exponent;
+
+    for (std::streampos next = stream.tellg(); stream >> op; next = stream.tellg())
+    {
+        //Rewind so the operator is parsed by the caller
+        if (POWER != evaluateOperator(op))
+        {
+            stream.clear();
+            stream.seekg(next);
+            break;
+        }
+
+        if (!(stream >> exponent)) throw ExceptionHandler("INVALID COMMAND : an operand must follow \"^\"");
+
+        base = power(base, exponent, computed);
+    }
+
+    return base;
+}
+
+//Return the factor that begins with |key|, either the matrix bound to |key| or the result of the function |key|
+//applied to the operands that follow in |stream|, which is held in |computed|
+//Each trailing "'" of |key|, and "trans", transposes the factor without computing anything
+Factor Interface::factor(const std::string& key, std::istringstream& stream, std::deque<Matrix>& computed) const
+{
+    const size_t marks = transposeMarks(key);
+    const std::string name = key.substr(0, key.size() - marks);
+    Factor result{nullptr, 1 == marks % 2};
+
+    switch (evaluateFunction(name))
+    {
+        case SOLVE :
+        {
+            computed.push_back(solve(stream));
+            result.matrix = &computed.back();
+            break;
+        }
+
+        case LEAST_SQUARES :
+        {
+            computed.push_back(leastSquares(stream));
+            result.matrix = &computed.back();
+            break;
+        }
+
+        case INVERSE :
+        {
+            computed.push_back(inverse(stream));
+            result.matrix = &computed.back();
+            break;
+        }
+
+        case KRONECKER :
+        {
+            computed.push_back(kronecker(stream));
+            result.matrix = &computed.back();
+            break;
+        }
+
+        //The operand of "trans" is itself a factor, so "trans A'" is A and "trans inv A" is the transposed inverse
+        case TRANSPOSE :
+        {
+            std::string next;
+            if (!(stream >> next)) throw ExceptionHandler("INVALID COMMAND : a matrix identifier must follow \"trans\"");
+
+            const Factor inner = factor(next, stream, computed);
+            result.matrix = inner.matrix;
+            result.transposed = (result.transposed != !inner.transposed);
+            break;
+        }
+
+        default : result.matrix = operand(name);
+    }
+
+    return result;
+}
+
+//Return |base| raised to the power |exponentKey|, the power is computed and held in |computed|
+//The power of a transposed view is the transpose of the power, so the power of the matrix is taken and the view kept
+//Will throw an exception if |exponentKey| is not a non-negative integer or |base| is not square
+Factor Interface::power(const Factor& base, const std::string& exponentKey, std::deque<Matrix>& computed)
+{
+    //Up to 18 digits always fit in |size_t|
+    bool valid = !exponentKey.empty() && exponentKey.size() < 19;
+    for (const char c : exponentKey) valid = valid && std::isdigit(c);
+
+    if (!valid)
+    {
+        throw ExceptionHandler("INVALID EXPONENT : \"" + exponentKey + "\" is not a non-negative integer, "
+                               "a negative power is a power of the inverse, inv id ^ k");
+    }
+
+    if (base._rows() != base._columns())
+        throw InvalidOperation("power", base.matrix, "Only a square matrix can be raised to a power");
+
+    computed.push_back(base.matrix->power(std::stoull(exponentKey)));
+
+    return Factor{&computed.back(), base.transposed};
+}
+
+//Return the number of "'" that end |key|, each one transposes the operand it follows
+size_t Interface::transposeMarks(const std::string& key)
+{
+    size_t marks = 0;
+    while (marks < key.size() && '\'' == key[key.size() - 1 - marks]) ++marks;
+
+    return marks;
+}
+
+//Return the Kronecker product of the matrices whose identifiers follow in |stream|
+//Will throw an exception if either identifier is missing or not bound to a matrix
+Matrix Interface::kronecker(std::istringstream& stream) const
+{
+    const Matrix* lhs = nextOperand(stream, "kron");
+    const Matrix* rhs = nextOperand(stream, "kron");
+
+    return lhs->kronecker(*rhs);
+}
+
+//Return the solution X of A * X = B for the identifiers of A and B that follow in |stream|
+//Will throw an exception if A is not square, is singular, or its rows do not match the rows of B
+Matrix Interface::solve(std::istringstream& stream) const
+{
+    const Matrix* lhs = squareOperand(stream, "solve");
+    const Matrix* rhs = nextOperand(stream, "solve");
+
+    if (lhs->_rows() != rhs->_rows())
+        throw InvalidOperation(lhs, '\\', rhs, "The degree of rows in the right-hand side must match the order of the matrix");
+
+    //The factorization is cached on |lhs|, solving it again against another right-hand side skips straight to the solve
+    if (lhs->factorization().singular())
+        throw InvalidOperation("solve", lhs, "The matrix is singular, the system has no unique solution");
+
+    return lhs->solve(*rhs);
+}
+
+//Return the least squares solution X of A * X = B for the identifiers of A and B that follow in |stream|
+//Will throw an exception if A has fewer rows than columns, is rank deficient, or its rows do not match the rows of B
+Matrix Interface::leastSquares(std::istringstream& stream) const
+{
+    const Matrix* lhs = nextOperand(stream, "lstsq");
+    const Matrix* rhs = nextOperand(stream, "lstsq");
+
+    if (lhs->_rows() < lhs->_columns())
+        throw InvalidOperation("lstsq", lhs, "The matrix must have at least as many rows as columns");
+
+    if (lhs->_rows() != rhs->_rows())
+        throw InvalidOperation(lhs, '\\', rhs,
+        "The degree of rows in the right-hand side must match the degree of rows in the matrix");
+
+    //The factorization is cached on |lhs|, fitting it again against another right-hand side only applies Q' and solves R
+    if (lhs->qrFactorization().rankDeficient())
+        throw InvalidOperation("lstsq", lhs, "The matrix is rank deficient, the least squares solution is not unique");
+
+    return lhs->leastSquares(*rhs);
+}
+
+//Return the inverse of the matrix whose identifier follows in |stream|
+//Will throw an exception if the matrix is not square, or is singular or nearly singular
+Matrix Interface::inverse(std::istringstream& stream) const
+{
+    const Matrix* source = squareOperand(stream, "inv");
+
+    if (source->factorization().singular())
+        throw InvalidOperation("inv", source, "The matrix is singular, it has no inverse (condition estimate : inf)");
+
+    Matrix result = source->inverse();
+
+    //The 1-norm condition number, exact since the inverse is already known
+    const double condition = source->oneNorm() * result.oneNorm();
+
+    if (!(condition < LU_CONDITION_LIMIT))
+    {
+        std::ostringstream message;
+        message << "The matrix is nearly singular, its inverse would be meaningless (condition estimate : " << condition << ')';
+        throw InvalidOperation("inv", source, message.str());
+    }
+
+    return result;
+}
+
+//Return the matrix named next in |stream|, an operand of |function|
+//Will throw an exception if no name follows or the name is not bound to a matrix
+const Matrix* Interface::nextOperand(std::istringstream& stream, const std::string& function) const
+{
+    std::string key;
+    if (!(stream >> key)) throw ExceptionHandler("INVALID COMMAND : a matrix identifier must follow \"" + function + '\"');
+
+    return operand(key);
+}
+
+//Return the matrix named next in |stream|, the operand of |function|
+//Will throw an exception if no name follows, the name is not bound to a matrix or the matrix is not square
+const Matrix* Interface::squareOperand(std::istringstream& stream, const std::string& function) const
+{
+    const Matrix* matrix = nextOperand(stream, function);
+
+    if (matrix->_rows() != matrix->_columns())
+        throw InvalidOperation(function, matrix, "The matrix must be square, with as many rows as columns");
+
+    return matrix;
+}
+
+//Move |matrix| into |matrixTree| and index it by its identifier, which must not be bound yet
+Matrix* Interface::bind(Matrix&& matrix)
+{
+    Matrix* stored = matrixTree.insert(std::move(matrix));
+    matrixIndex.insert(stored);
+
+    return stored;
+}
+
+//Remove the matrix bound to |key| and release its memory
+//The index reads the identifier from the matrix, so it lets go of the matrix before the tree destroys it
+bool Interface::unbind(const std::string& key)
+{
+    if (!matrixIndex.erase(key)) return false;
+
+    matrixTree.remove<std::string>(key);
+    return true;
+}
+
 //Check if |key| is already bound to an existing matrix
 //If it is, ask whether the user wants to overwrite with a new matrix
 //If the |key| is unique, return true, otherwise return false
 bool Interface::overwriteCheck(std::string& key)
 {
-    Matrix* retrieved = matrixTree.retrieve<std::string>(key);
+    Matrix* retrieved = lookup(key);
 
     //If a matrix was retrieved
     if (retrieved)
@@ -439,6 +1527,7 @@ bool Interface::overwriteCheck(std::string& key)
         if (getYesNo() && getMatrixInput(key, matrixString, rows, columns))
         {
             retrieved->overwrite(Matrix(key, matrixString, rows, columns));
+            retrieved->adaptStorage();
             std::cout << "\n\"" << key << "\" successfully overwritten\n\n";
         }
 
@@ -4,6 +4,10 @@ Interface class constructor is parameterized to take in a filename to allow for
 stored in a file upon exiting the program. The Interface works directly with |Tree.hpp| to define and store matrices in
 a data structure in the form of a Red-Black Tree.
 
+Identifiers are looked up through a hash index of the same matrices (see |Index.hpp|), and the tree keeps them in
+order for display, prefix removal and the data file. A matrix is always added to or removed from both at once, so the
+two hold the same matrices.
+
 @Sean Siders
 sean.siders@icloud.com
 */
@@ -13,9 +17,23 @@ sean.siders@icloud.com
 
 #include <iostream>
 #include <sstream>
+#include <cstdlib>
+#include <cmath>
+#include <deque>
+#include <limits>
+#include <string_view>
+#include <vector>
 #include "Matrix.hpp"
 #include "Tree.hpp"
+#include "Index.hpp"
 #include "ExceptionHandler.hpp"
+#include "Kernels.hpp"
+#include "ThreadPool.hpp"
+#include "Strassen.hpp"
+#include "Lu.hpp"
+#include "Qr.hpp"
+#include "Eigen.hpp"
+#include "Rational.hpp"
 
 //This enum is used to efficiently branch the program to different processes
 enum Commands
@@ -25,6 +43,15 @@ enum Commands
     CLEAR, //The user wants to clear the screen
     OPERATE, //The user may be trying to apply 1 or more matrix operations
     HELP, //The user wants help on how to use Lina
+    ISA, //The user wants to display or force the instruction set used by the numeric kernels
+    THREADS, //The user wants to display or set the number of threads used by matrix operations
+    STRASSEN, //The user wants to configure or check the Strassen-Winograd multiplication mode
+    DET, //The user wants the determinant of a matrix
+    LU, //The user wants the LU factorization of a matrix
+    QR, //The user wants the QR factorization of a matrix, stored as two new matrices
+    EIG, //The user wants the eigenvalues, and possibly eigenvectors, of a symmetric matrix stored as new matrices
+    EXACT, //The user wants a matrix, its determinant, inverse or a solution displayed as exact fractions
+    UNDEFINE, //The user wants to remove 1 or more matrices
     QUIT //Terminate the program
 };
 
@@ -35,9 +62,49 @@ enum Operators
     PLUS, //The user wants to add matrices
     MINUS, //The user wants to subtract matrices
     MULTIPLY, //The user wants to multiply matrices
+    POWER, //The user wants to raise a square matrix to an integer power
+    HADAMARD, //The user wants to multiply matrices entry by entry
+    QUOTIENT, //The user wants to divide matrices entry by entry
     ASSIGN //The user wants to assign an identifier to the resulting matrix
 };
 
+//This enum is used for the functions that may appear in place of an operand within an expression
+enum Functions
+{
+    NO_FUNCTION, //The operand is a matrix identifier
+    SOLVE, //The solution X of A * X = B
+    INVERSE, //The inverse of a matrix
+    TRANSPOSE, //The transpose of a matrix
+    LEAST_SQUARES, //The least squares solution X of A * X = B
+    KRONECKER //The Kronecker product of two matrices
+};
+
+//One operand of a product : a matrix, read as its transpose when |transposed|
+//A transposed factor is a view, products read it in place and the transpose is never formed
+struct Factor
+{
+    const Matrix* matrix;
+
+    bool transposed;
+
+    size_t _rows() const { return transposed ? matrix->_columns() : matrix->_rows(); }
+
+    size_t _columns() const { return transposed ? matrix->_rows() : matrix->_columns(); }
+};
+
+//One term of a parsed expression : the product of its |factors|, added to or subtracted from the result
+struct Term
+{
+    //The operands multiplied together, left to right
+    std::vector<Factor> factors;
+
+    //True if the term is subtracted
+    bool negate;
+
+    //Every entry of the term is multiplied by |scale|, the product of its scalar operands
+    double scale;
+};
+
 class Interface
 {
     public:
@@ -53,10 +120,24 @@ class Interface
     //The data structure that holds all defined matrices by their keys
     Tree<Matrix> matrixTree;
 
+    //Every matrix of |matrixTree| by its identifier, for lookups in constant time
+    HashIndex<Matrix> matrixIndex;
+
     //The most recent matrix that has been referenced by the user
     //Used for direct access, avoiding the need for retrieval from |matrixTree|
     Matrix* recent;
 
+    //Return the matrix bound to |key|, or null if there is none
+    Matrix* lookup(const std::string_view key) const { return matrixIndex.find(key); }
+
+    //Move |matrix| into |matrixTree| and index it by its identifier, which must not be bound yet
+    //Return a pointer to the stored matrix
+    Matrix* bind(Matrix&& matrix);
+
+    //Remove the matrix bound to |key| and release its memory
+    //Return false if there is none
+    bool unbind(const std::string& key);
+
     //Determine which command the user entered, return the respective |Commands|
     static Commands evaluateCommand(const std::string& command);
 
@@ -76,36 +157,161 @@ class Interface
     //Either display all matrices or specified matrices by key as additional arguments in the |stream|
     void display(std::istringstream& stream) const;
 
+    //Remove each matrix named in |stream| and release its memory, an identifier ending with '*' removes every matrix
+    //whose identifier begins with what precedes the '*'
+    //Will throw an exception if no identifier follows
+    void undefine(std::istringstream& stream);
+
     //Print 100 newline characters
     void clearScreen() const;
+
+    //Display the instruction set the numeric kernels use
+    //If an instruction set name follows in |stream|, force the kernels to that set
+    void isa(std::istringstream& stream) const;
+
+    //Display the number of threads matrix operations run on
+    //If a count follows in |stream|, resize the thread pool to that count
+    void threads(std::istringstream& stream) const;
+
+    //Display the Strassen-Winograd settings after applying the argument in |stream|, which may be :
+    //  "on" / "off" : enable or disable the mode
+    //  N : set the crossover size
+    //  "check" id1 id2 : compare the Strassen-Winograd product of two matrices against the classic product
+    void strassenMode(std::istringstream& stream) const;
+
+    //Display the determinant of the matrix named in |stream|
+    void det(std::istringstream& stream) const;
+
+    //Display the L, U and P factors of the matrix named in |stream|, where P * A = L * U
+    void lu(std::istringstream& stream) const;
+
+    //Store the factors Q and R of the matrix named in |stream|, where A = Q * R
+    //They are named after the two identifiers that follow, or after the matrix with "_Q" and "_R" appended
+    void qr(std::istringstream& stream);
+
+    //Store the eigenvalues of the symmetric matrix named in |stream| as a column named after the matrix with "_eig"
+    //appended, and its eigenvectors as the columns of a matrix with "_vec" appended if "vectors" follows
+    //Will throw an exception if the matrix is not square or not symmetric
+    void eig(std::istringstream& stream);
+
+    //Display the matrix named in |stream| with its entries as exact fractions, or when "det", "inv" or "solve" comes
+    //first, the exact determinant, inverse or solution of a linear system, or with "check" the results of known cases
+    //Will throw an exception if an entry is not finite, a matrix is not square where it must be, or is singular
+    void exact(std::istringstream& stream) const;
+
+    //Return the entries of |source| as exact fractions
+    //Will throw an exception for |function| if an entry is not finite
+    static RationalMatrix rational(const Matrix* source, const std::string& function);
+
+    //Bind |result| to |key|, if |key| is already bound the user decides whether to overwrite
+    //Only the identifier and order are displayed, the matrix may be far too large to print
+    void store(const std::string& key, Matrix&& result);
     
     //Prompt the user with instructions on how to use Lina
     void helpPrompt() const;
 
+    //Either assign the expression that follows '=' in |stream| to |lhsKey|
+    //Or evaluate and display the expression that begins with the operand |lhsKey|
     void operate(const std::string& lhsKey, std::istringstream& stream);
 
-    //Returns the resulting matrix, used in |assign|
-    void operate(const Matrix* lhs, const Operators op, const Matrix* rhs, Matrix*& result, const std::string& resultKey);
-
     //Evaluate which operator the user input, then return the cooresponding enum
     Operators evaluateOperator(const std::string& operatorString) const;
 
-    //Attempt to add two matrices |lhs| and |rhs|
-    //If |positive| is false, |rhs| will be subracted from |lhs|
-    //If the matrices are not of the same order, addition cannot occur, an exception is thrown
-    static void add(const Matrix* lhs, const Matrix* rhs, const bool positive);
+    //Evaluate which function |name| refers to, return |NO_FUNCTION| if it is not a function
+    static Functions evaluateFunction(const std::string& name);
 
-    //Attempt to multiple two matrices |lhs| and |rhs|
-    //If the columns of |lhs| do not match the rows of |rhs|, multiplication cannot occur, return false
-    static void multiply(const Matrix* lhs, const Matrix* rhs);
+    //True if |key| may not name a matrix : it is a command or function id, a number, or ends with "'"
+    static bool reservedIdentifier(const std::string& key);
 
-    //Attempt to assign |result| as the resulting matrix from an operation that begins with |lhs|
-    //Proceed to read in the operator, and the righ operand matrix
+    //True if |key| is a number, such as 2.5, -3 or 1e-6, which is then written into |value|
+    static bool scalarLiteral(const std::string& key, double& value);
+
+    //Parse the expression that begins with the operand |firstKey| and continues in |stream| into |terms|
+    //Functions are computed as they are parsed, their results are held in |computed|
+    //EXPRESSION GRAMMAR
+    //  expression : term { ('+' | '-') term }
+    //  term : operand { ('*' | ".*" | "./") operand }
+    //  operand : number | power
+    //  power : factor { '^' integer }
+    //  factor : id | id"'" | "solve" id id | "lstsq" id id | "inv" id | "kron" id id | "trans" factor
     //Will throw an exception if :
-    //  - The operator is invalid 
-    //  - The operator is another assignment (=)
-    //  - The right operand identifier does not exist
-    void assign(Matrix*& result, const std::string& resultKey, const Matrix* lhs, std::istringstream& stream);
+    //  - An operator is invalid
+    //  - An operand identifier does not exist
+    //  - The orders of the operands do not allow the operation
+    void parseExpression(const std::string& firstKey, std::istringstream& stream, std::vector<Term>& terms,
+                         std::deque<Matrix>& computed) const;
+
+    //Extend |term| with the operand |key|, joined to the term so far by |op|, which is |MULTIPLY|, |HADAMARD| or |QUOTIENT|
+    //A number scales the term, and an elementwise operator is applied to the product of the term so far at once
+    //Will throw an exception if the orders of the operands do not allow the operation, or the scale is not finite
+    void extendTerm(Term& term, const Operators op, const std::string& key, std::istringstream& stream,
+                    std::deque<Matrix>& computed) const;
+
+    //Return |base| raised to every "^ k" that follows in |stream|, leaving any other operator in |stream|
+    Factor powers(Factor base, std::istringstream& stream, std::deque<Matrix>& computed) const;
+
+    //Return the factor that begins with |key|, either the matrix bound to |key| or the result of the function |key|
+    //applied to the operands that follow in |stream|, which is held in |computed|
+    //Each trailing "'" of |key|, and "trans", transposes the factor without computing anything
+    Factor factor(const std::string& key, std::istringstream& stream, std::deque<Matrix>& computed) const;
+
+    //Return |base| raised to the power |exponentKey|, the power is computed and held in |computed|
+    //Will throw an exception if |exponentKey| is not a non-negative integer or |base| is not square
+    static Factor power(const Factor& base, const std::string& exponentKey, std::deque<Matrix>& computed);
+
+    //Return the number of "'" that end |key|, each one transposes the operand it follows
+    static size_t transposeMarks(const std::string& key);
+
+    //Return the solution X of A * X = B for the identifiers of A and B that follow in |stream|
+    //Will throw an exception if A is not square, is singular, or its rows do not match the rows of B
+    Matrix solve(std::istringstream& stream) const;
+
+    //Return the least squares solution X of A * X = B for the identifiers of A and B that follow in |stream|
+    //Will throw an exception if A has fewer rows than columns, is rank deficient, or its rows do not match the rows of B
+    Matrix leastSquares(std::istringstream& stream) const;
+
+    //Return the Kronecker product of the matrices whose identifiers follow in |stream|
+    //Will throw an exception if either identifier is missing or not bound to a matrix
+    Matrix kronecker(std::istringstream& stream) const;
+
+    //Return the inverse of the matrix whose identifier follows in |stream|
+    //Will throw an exception if the matrix is not square, or is singular or nearly singular
+    Matrix inverse(std::istringstream& stream) const;
+
+    //Return the matrix resulting from the parsed |terms|
+    //Products bind tighter than sums, the sum of every term is fused into a single pass over memory
+    //The result is returned by value and moved onward, its buffer is allocated exactly once
+    static Matrix evaluateExpression(const std::vector<Term>& terms);
+
+    //Return the product of |factors|, multiplied in the order that takes the fewest floating point operations
+    //A single factor is returned as a copy, transposed if it is a transposed view
+    static Matrix product(const std::vector<Factor>& factors);
+
+    //Return the split of every chain of |factors| in the order that multiplies it with the fewest operations
+    //The chain of factors i through j, i < j, is the product of chains i through k and k + 1 through j, where k is
+    //entry i * |factors.size()| + j of the result
+    static std::vector<size_t> chainOrder(const std::vector<Factor>& factors);
+
+    //Return the product of the chain of |factors| |first| through |last|, |first| < |last|, split as |splits| directs
+    static Matrix chainProduct(const std::vector<Factor>& factors, const std::vector<size_t>& splits, const size_t first,
+                               const size_t last);
+
+    //Assign the result of the expression in |stream| to |resultKey|
+    //If |resultKey| is already bound to a matrix, the user will have to decide if they want to overwrite
+    //Will throw an exception if the expression is invalid
+    void assign(const std::string& resultKey, std::istringstream& stream);
+
+    //Return the matrix bound to |key|
+    //Will throw an exception if |key| is not bound to a matrix
+    const Matrix* operand(const std::string& key) const;
+
+    //Return the matrix named next in |stream|, an operand of |function|
+    //Will throw an exception if no name follows or the name is not bound to a matrix
+    const Matrix* nextOperand(std::istringstream& stream, const std::string& function) const;
+
+    //Return the matrix named next in |stream|, the operand of |function|
+    //Will throw an exception if no name follows, the name is not bound to a matrix or the matrix is not square
+    const Matrix* squareOperand(std::istringstream& stream, const std::string& function) const;
 
     //Check if |key| is already bound to an existing matrix
     //If it is, ask whether the user wants to overwrite with a new matrix
@@ -0,0 +1,576 @@
+/*
+@Sean Siders
+sean.siders@icloud.com
+*/
+
+#include "Kernels.hpp"
+#include "Gemm.hpp"
+#include <cstdlib>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define LINA_X86 1
+#include <immintrin.h>
+#else
+#define LINA_X86 0
+#endif
+
+//////// SCALAR KERNELS
+
+static void addScalar(double* y, const double* x, const size_t n)
+{
+    for (size_t i = 0; i < n; ++i) y[i] += x[i];
+}
+
+static void subtractScalar(double* y, const double* x, const size_t n)
+{
+    for (size_t i = 0; i < n; ++i) y[i] -= x[i];
+}
+
+static void sumScalar(double* z, const double* x, const double* y, const size_t n)
+{
+    for (size_t i = 0; i < n; ++i) z[i] = x[i] + y[i];
+}
+
+static void differenceScalar(double* z, const double* x, const double* y, const size_t n)
+{
+    for (size_t i = 0; i < n; ++i) z[i] = x[i] - y[i];
+}
+
+static void productScalar(double* z, const double* x, const double* y, const size_t n)
+{
+    for (size_t i = 0; i < n; ++i) z[i] = x[i] * y[i];
+}
+
+static void quotientScalar(double* z, const double* x, const double* y, const size_t n)
+{
+    for (size_t i = 0; i < n; ++i) z[i] = x[i] / y[i];
+}
+
+static void scaleScalar(double* y, const double a, const double* x, const size_t n)
+{
+    for (size_t i = 0; i < n; ++i) y[i] = a * x[i];
+}
+
+static void axpyScalar(double* y, const double a, const double* x, const size_t n)
+{
+    for (size_t i = 0; i < n; ++i) y[i] += a * x[i];
+}
+
+static void microKernelScalar(const size_t kc, const double alpha, const double* a, const double* b, double* C, const size_t ldc)
+{
+    double accumulator[GEMM_MR][GEMM_NR] = {};
+
+    for (size_t p = 0; p < kc; ++p)
+    {
+        for (size_t i = 0; i < GEMM_MR; ++i)
+        {
+            const double entry = a[i];
+
+            for (size_t j = 0; j < GEMM_NR; ++j) accumulator[i][j] += entry * b[j];
+        }
+
+        a += GEMM_MR;
+        b += GEMM_NR;
+    }
+
+    for (size_t i = 0; i < GEMM_MR; ++i)
+    {
+        for (size_t j = 0; j < GEMM_NR; ++j) C[i * ldc + j] += alpha * accumulator[i][j];
+    }
+}
+
+#if LINA_X86
+
+//////// SSE2 KERNELS
+
+__attribute__((target("sse2")))
+static void addSse2(double* y, const double* x, const size_t n)
+{
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) _mm_storeu_pd(y + i, _mm_add_pd(_mm_loadu_pd(y + i), _mm_loadu_pd(x + i)));
+    for (; i < n; ++i) y[i] += x[i];
+}
+
+__attribute__((target("sse2")))
+static void subtractSse2(double* y, const double* x, const size_t n)
+{
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) _mm_storeu_pd(y + i, _mm_sub_pd(_mm_loadu_pd(y + i), _mm_loadu_pd(x + i)));
+    for (; i < n; ++i) y[i] -= x[i];
+}
+
+__attribute__((target("sse2")))
+static void sumSse2(double* z, const double* x, const double* y, const size_t n)
+{
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) _mm_storeu_pd(z + i, _mm_add_pd(_mm_loadu_pd(x + i), _mm_loadu_pd(y + i)));
+    for (; i < n; ++i) z[i] = x[i] + y[i];
+}
+
+__attribute__((target("sse2")))
+static void differenceSse2(double* z, const double* x, const double* y, const size_t n)
+{
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) _mm_storeu_pd(z + i, _mm_sub_pd(_mm_loadu_pd(x + i), _mm_loadu_pd(y + i)));
+    for (; i < n; ++i) z[i] = x[i] - y[i];
+}
+
+__attribute__((target("sse2")))
+static void productSse2(double* z, const double* x, const double* y, const size_t n)
+{
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) _mm_storeu_pd(z + i, _mm_mul_pd(_mm_loadu_pd(x + i), _mm_loadu_pd(y + i)));
+    for (; i < n; ++i) z[i] = x[i] * y[i];
+}
+
+__attribute__((target("sse2")))
+static void quotientSse2(double* z, const double* x, const double* y, const size_t n)
+{
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) _mm_storeu_pd(z + i, _mm_div_pd(_mm_loadu_pd(x + i), _mm_loadu_pd(y + i)));
+    for (; i < n; ++i) z[i] = x[i] / y[i];
+}
+
+__attribute__((target("sse2")))
+static void scaleSse2(double* y, const double a, const double* x, const size_t n)
+{
+    const __m128d scale = _mm_set1_pd(a);
+
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) _mm_storeu_pd(y + i, _mm_mul_pd(scale, _mm_loadu_pd(x + i)));
+    for (; i < n; ++i) y[i] = a * x[i];
+}
+
+__attribute__((target("sse2")))
+static void axpySse2(double* y, const double a, const double* x, const size_t n)
+{
+    const __m128d scale = _mm_set1_pd(a);
+
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2)
+        _mm_storeu_pd(y + i, _mm_add_pd(_mm_loadu_pd(y + i), _mm_mul_pd(scale, _mm_loadu_pd(x + i))));
+    for (; i < n; ++i) y[i] += a * x[i];
+}
+
+//Each row of the tile is held in 4 registers of 2 entries
+__attribute__((target("sse2")))
+static void microKernelSse2(const size_t kc, const double alpha, const double* a, const double* b, double* C, const size_t ldc)
+{
+    __m128d accumulator[GEMM_MR][4];
+    for (size_t i = 0; i < GEMM_MR; ++i)
+        for (size_t j = 0; j < 4; ++j) accumulator[i][j] = _mm_setzero_pd();
+
+    for (size_t p = 0; p < kc; ++p)
+    {
+        const __m128d b0 = _mm_load_pd(b);
+        const __m128d b1 = _mm_load_pd(b + 2);
+        const __m128d b2 = _mm_load_pd(b + 4);
+        const __m128d b3 = _mm_load_pd(b + 6);
+
+        for (size_t i = 0; i < GEMM_MR; ++i)
+        {
+            const __m128d entry = _mm_set1_pd(a[i]);
+            accumulator[i][0] = _mm_add_pd(accumulator[i][0], _mm_mul_pd(entry, b0));
+            accumulator[i][1] = _mm_add_pd(accumulator[i][1], _mm_mul_pd(entry, b1));
+            accumulator[i][2] = _mm_add_pd(accumulator[i][2], _mm_mul_pd(entry, b2));
+            accumulator[i][3] = _mm_add_pd(accumulator[i][3], _mm_mul_pd(entry, b3));
+        }
+
+        a += GEMM_MR;
+        b += GEMM_NR;
+    }
+
+    const __m128d scale = _mm_set1_pd(alpha);
+    for (size_t i = 0; i < GEMM_MR; ++i)
+    {
+        for (size_t j = 0; j < 4; ++j)
+        {
+            double* c = C + i * ldc + 2 * j;
+            _mm_storeu_pd(c, _mm_add_pd(_mm_loadu_pd(c), _mm_mul_pd(scale, accumulator[i][j])));
+        }
+    }
+}
+
+//////// AVX2 KERNELS
+
+__attribute__((target("avx2,fma")))
+static void addAvx2(double* y, const double* x, const size_t n)
+{
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        _mm256_storeu_pd(y + i, _mm256_add_pd(_mm256_loadu_pd(y + i), _mm256_loadu_pd(x + i)));
+        _mm256_storeu_pd(y + i + 4, _mm256_add_pd(_mm256_loadu_pd(y + i + 4), _mm256_loadu_pd(x + i + 4)));
+    }
+    for (; i < n; ++i) y[i] += x[i];
+}
+
+__attribute__((target("avx2,fma")))
+static void subtractAvx2(double* y, const double* x, const size_t n)
+{
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        _mm256_storeu_pd(y + i, _mm256_sub_pd(_mm256_loadu_pd(y + i), _mm256_loadu_pd(x + i)));
+        _mm256_storeu_pd(y + i + 4, _mm256_sub_pd(_mm256_loadu_pd(y + i + 4), _mm256_loadu_pd(x + i + 4)));
+    }
+    for (; i < n; ++i) y[i] -= x[i];
+}
+
+__attribute__((target("avx2,fma")))
+static void sumAvx2(double* z, const double* x, const double* y, const size_t n)
+{
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        _mm256_storeu_pd(z + i, _mm256_add_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i)));
+        _mm256_storeu_pd(z + i + 4, _mm256_add_pd(_mm256_loadu_pd(x + i + 4), _mm256_loadu_pd(y + i + 4)));
+    }
+    for (; i < n; ++i) z[i] = x[i] + y[i];
+}
+
+__attribute__((target("avx2,fma")))
+static void differenceAvx2(double* z, const double* x, const double* y, const size_t n)
+{
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        _mm256_storeu_pd(z + i, _mm256_sub_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i)));
+        _mm256_storeu_pd(z + i + 4, _mm256_sub_pd(_mm256_loadu_pd(x + i + 4), _mm256_loadu_pd(y + i + 4)));
+    }
+    for (; i < n; ++i) z[i] = x[i] - y[i];
+}
+
+__attribute__((target("avx2,fma")))
+static void productAvx2(double* z, const double* x, const double* y, const size_t n)
+{
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        _mm256_storeu_pd(z + i, _mm256_mul_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i)));
+        _mm256_storeu_pd(z + i + 4, _mm256_mul_pd(_mm256_loadu_pd(x + i + 4), _mm256_loadu_pd(y + i + 4)));
+    }
+    for (; i < n; ++i) z[i] = x[i] * y[i];
+}
+
+__attribute__((target("avx2,fma")))
+static void quotientAvx2(double* z, const double* x, const double* y, const size_t n)
+{
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        _mm256_storeu_pd(z + i, _mm256_div_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i)));
+        _mm256_storeu_pd(z + i + 4, _mm256_div_pd(_mm256_loadu_pd(x + i + 4), _mm256_loadu_pd(y + i + 4)));
+    }
+    for (; i < n; ++i) z[i] = x[i] / y[i];
+}
+
+__attribute__((target("avx2,fma")))
+static void scaleAvx2(double* y, const double a, const double* x, const size_t n)
+{
+    const __m256d scale = _mm256_set1_pd(a);
+
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        _mm256_storeu_pd(y + i, _mm256_mul_pd(scale, _mm256_loadu_pd(x + i)));
+        _mm256_storeu_pd(y + i + 4, _mm256_mul_pd(scale, _mm256_loadu_pd(x + i + 4)));
+    }
+    for (; i < n; ++i) y[i] = a * x[i];
+}
+
+__attribute__((target("avx2,fma")))
+static void axpyAvx2(double* y, const double a, const double* x, const size_t n)
+{
+    const __m256d scale = _mm256_set1_pd(a);
+
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        _mm256_storeu_pd(y + i, _mm256_fmadd_pd(scale, _mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i)));
+        _mm256_storeu_pd(y + i + 4, _mm256_fmadd_pd(scale, _mm256_loadu_pd(x + i + 4), _mm256_loadu_pd(y + i + 4)));
+    }
+    for (; i < n; ++i) y[i] += a * x[i];
+}
+
+//Each row of the tile is held in 2 registers of 4 entries
+__attribute__((target("avx2,fma")))
+static void microKernelAvx2(const size_t kc, const double alpha, const double* a, const double* b, double* C, const size_t ldc)
+{
+    __m256d c00 = _mm256_setzero_pd(), c01 = _mm256_setzero_pd();
+    __m256d c10 = _mm256_setzero_pd(), c11 = _mm256_setzero_pd();
+    __m256d c20 = _mm256_setzero_pd(), c21 = _mm256_setzero_pd();
+    __m256d c30 = _mm256_setzero_pd(), c31 = _mm256_setzero_pd();
+
+    for (size_t p = 0; p < kc; ++p)
+    {
+        const __m256d b0 = _mm256_load_pd(b);
+        const __m256d b1 = _mm256_load_pd(b + 4);
+
+        __m256d entry = _mm256_broadcast_sd(a);
+        c00 = _mm256_fmadd_pd(entry, b0, c00);
+        c01 = _mm256_fmadd_pd(entry, b1, c01);
+
+        entry = _mm256_broadcast_sd(a + 1);
+        c10 = _mm256_fmadd_pd(entry, b0, c10);
+        c11 = _mm256_fmadd_pd(entry, b1, c11);
+
+        entry = _mm256_broadcast_sd(a + 2);
+        c20 = _mm256_fmadd_pd(entry, b0, c20);
+        c21 = _mm256_fmadd_pd(entry, b1, c21);
+
+        entry = _mm256_broadcast_sd(a + 3);
+        c30 = _mm256_fmadd_pd(entry, b0, c30);
+        c31 = _mm256_fmadd_pd(entry, b1, c31);
+
+        a += GEMM_MR;
+        b += GEMM_NR;
+    }
+
+    const __m256d scale = _mm256_set1_pd(alpha);
+    const __m256d rows[GEMM_MR][2] = {{c00, c01}, {c10, c11}, {c20, c21}, {c30, c31}};
+
+    for (size_t i = 0; i < GEMM_MR; ++i)
+    {
+        double* c = C + i * ldc;
+        _mm256_storeu_pd(c, _mm256_fmadd_pd(scale, rows[i][0], _mm256_loadu_pd(c)));
+        _mm256_storeu_pd(c + 4, _mm256_fmadd_pd(scale, rows[i][1], _mm256_loadu_pd(c + 4)));
+    }
+}
+
+//////// AVX-512 KERNELS
+
+__attribute__((target("avx512f")))
+static void addAvx512(double* y, const double* x, const size_t n)
+{
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) _mm512_storeu_pd(y + i, _mm512_add_pd(_mm512_loadu_pd(y + i), _mm512_loadu_pd(x + i)));
+    for (; i < n; ++i) y[i] += x[i];
+}
+
+__attribute__((target("avx512f")))
+static void subtractAvx512(double* y, const double* x, const size_t n)
+{
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) _mm512_storeu_pd(y + i, _mm512_sub_pd(_mm512_loadu_pd(y + i), _mm512_loadu_pd(x + i)));
+    for (; i < n; ++i) y[i] -= x[i];
+}
+
+__attribute__((target("avx512f")))
+static void sumAvx512(double* z, const double* x, const double* y, const size_t n)
+{
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) _mm512_storeu_pd(z + i, _mm512_add_pd(_mm512_loadu_pd(x + i), _mm512_loadu_pd(y + i)));
+    for (; i < n; ++i) z[i] = x[i] + y[i];
+}
+
+__attribute__((target("avx512f")))
+static void differenceAvx512(double* z, const double* x, const double* y, const size_t n)
+{
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) _mm512_storeu_pd(z + i, _mm512_sub_pd(_mm512_loadu_pd(x + i), _mm512_loadu_pd(y + i)));
+    for (; i < n; ++i) z[i] = x[i] - y[i];
+}
+
+__attribute__((target("avx512f")))
+static void productAvx512(double* z, const double* x, const double* y, const size_t n)
+{
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) _mm512_storeu_pd(z + i, _mm512_mul_pd(_mm512_loadu_pd(x + i), _mm512_loadu_pd(y + i)));
+    for (; i < n; ++i) z[i] = x[i] * y[i];
+}
+
+__attribute__((target("avx512f")))
+static void quotientAvx512(double* z, const double* x, const double* y, const size_t n)
+{
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) _mm512_storeu_pd(z + i, _mm512_div_pd(_mm512_loadu_pd(x + i), _mm512_loadu_pd(y + i)));
+    for (; i < n; ++i) z[i] = x[i] / y[i];
+}
+
+__attribute__((target("avx512f")))
+static void scaleAvx512(double* y, const double a, const double* x, const size_t n)
+{
+    const __m512d scale = _mm512_set1_pd(a);
+
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) _mm512_storeu_pd(y + i, _mm512_mul_pd(scale, _mm512_loadu_pd(x + i)));
+    for (; i < n; ++i) y[i] = a * x[i];
+}
+
+__attribute__((target("avx512f")))
+static void axpyAvx512(double* y, const double a, const double* x, const size_t n)
+{
+    const __m512d scale = _mm512_set1_pd(a);
+
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+        _mm512_storeu_pd(y + i, _mm512_fmadd_pd(scale, _mm512_loadu_pd(x + i), _mm512_loadu_pd(y + i)));
+    for (; i < n; ++i) y[i] += a * x[i];
+}
+
+//Each row of the tile is a single register of 8 entries
+//Even and odd steps of |kc| accumulate separately to hide the fused multiply-add latency
+__attribute__((target("avx512f")))
+static void microKernelAvx512(const size_t kc, const double alpha, const double* a, const double* b, double* C, const size_t ldc)
+{
+    __m512d even0 = _mm512_setzero_pd(), even1 = _mm512_setzero_pd();
+    __m512d even2 = _mm512_setzero_pd(), even3 = _mm512_setzero_pd();
+    __m512d odd0 = _mm512_setzero_pd(), odd1 = _mm512_setzero_pd();
+    __m512d odd2 = _mm512_setzero_pd(), odd3 = _mm512_setzero_pd();
+
+    size_t p = 0;
+    for (; p + 2 <= kc; p += 2)
+    {
+        const __m512d b0 = _mm512_load_pd(b);
+        const __m512d b1 = _mm512_load_pd(b + GEMM_NR);
+
+        even0 = _mm512_fmadd_pd(_mm512_set1_pd(a[0]), b0, even0);
+        even1 = _mm512_fmadd_pd(_mm512_set1_pd(a[1]), b0, even1);
+        even2 = _mm512_fmadd_pd(_mm512_set1_pd(a[2]), b0, even2);
+        even3 = _mm512_fmadd_pd(_mm512_set1_pd(a[3]), b0, even3);
+
+        odd0 = _mm512_fmadd_pd(_mm512_set1_pd(a[4]), b1, odd0);
+        odd1 = _mm512_fmadd_pd(_mm512_set1_pd(a[5]), b1, odd1);
+        odd2 = _mm512_fmadd_pd(_mm512_set1_pd(a[6]), b1, odd2);
+        odd3 = _mm512_fmadd_pd(_mm512_set1_pd(a[7]), b1, odd3);
+
+        a += 2 * GEMM_MR;
+        b += 2 * GEMM_NR;
+    }
+
+    if (p < kc)
+    {
+        const __m512d b0 = _mm512_load_pd(b);
+
+        even0 = _mm512_fmadd_pd(_mm512_set1_pd(a[0]), b0, even0);
+        even1 = _mm512_fmadd_pd(_mm512_set1_pd(a[1]), b0, even1);
+        even2 = _mm512_fmadd_pd(_mm512_set1_pd(a[2]), b0, even2);
+        even3 = _mm512_fmadd_pd(_mm512_set1_pd(a[3]), b0, even3);
+    }
+
+    const __m512d scale = _mm512_set1_pd(alpha);
+    const __m512d rows[GEMM_MR] =
+    {
+        _mm512_add_pd(even0, odd0), _mm512_add_pd(even1, odd1),
+        _mm512_add_pd(even2, odd2), _mm512_add_pd(even3, odd3)
+    };
+
+    for (size_t i = 0; i < GEMM_MR; ++i)
+    {
+        double* c = C + i * ldc;
+        _mm512_storeu_pd(c, _mm512_fmadd_pd(scale, rows[i], _mm512_loadu_pd(c)));
+    }
+}
+
+#endif //LINA_X86
+
+//////// KERNEL TABLES
+
+//Indexed by |Isa|, sets that cannot be compiled on this architecture fall back to the scalar kernels
+static const KernelTable TABLES[] =
+{
+    {ISA_SCALAR, "scalar", addScalar, subtractScalar, sumScalar, differenceScalar, productScalar, quotientScalar,
+     scaleScalar, axpyScalar, microKernelScalar},
+#if LINA_X86
+    {ISA_SSE2, "sse2", addSse2, subtractSse2, sumSse2, differenceSse2, productSse2, quotientSse2, scaleSse2, axpySse2,
+     microKernelSse2},
+    {ISA_AVX2, "avx2", addAvx2, subtractAvx2, sumAvx2, differenceAvx2, productAvx2, quotientAvx2, scaleAvx2, axpyAvx2,
+     microKernelAvx2},
+    {ISA_AVX512, "avx512", addAvx512, subtractAvx512, sumAvx512, differenceAvx512, productAvx512, quotientAvx512,
+     scaleAvx512, axpyAvx512, microKernelAvx512}
+#else
+    {ISA_SSE2, "sse2", addScalar, subtractScalar, sumScalar, differenceScalar, productScalar, quotientScalar,
+     scaleScalar, axpyScalar, microKernelScalar},
+    {ISA_AVX2, "avx2", addScalar, subtractScalar, sumScalar, differenceScalar, productScalar, quotientScalar,
+     scaleScalar, axpyScalar, microKernelScalar},
+    {ISA_AVX512, "avx512", addScalar, subtractScalar, sumScalar, differenceScalar, productScalar, quotientScalar,
+     scaleScalar, axpyScalar, microKernelScalar}
+#endif
+};
+
+//Return the fastest instruction set the host CPU supports
+static Isa detectIsa()
+{
+    if (isaSupported(ISA_AVX512)) return ISA_AVX512;
+    if (isaSupported(ISA_AVX2)) return ISA_AVX2;
+    if (isaSupported(ISA_SSE2)) return ISA_SSE2;
+
+    return ISA_SCALAR;
+}
+
+//Return the table selected at startup, honoring LINA_ISA when the CPU supports it
+static const KernelTable* startupTable()
+{
+    Isa isa = detectIsa();
+    Isa forced = ISA_SCALAR;
+    const char* name = std::getenv("LINA_ISA");
+
+    if (name && parseIsa(name, forced) && isaSupported(forced)) isa = forced;
+
+    return &TABLES[isa];
+}
+
+//The kernel table in use
+static const KernelTable*& currentTable()
+{
+    static const KernelTable* table = startupTable();
+    return table;
+}
+
+//////// FUNCTIONS
+
+//Return the kernel table in use, detecting the best instruction set on the first call
+const KernelTable& kernels()
+{
+    return *currentTable();
+}
+
+//True if the host CPU can run |isa|
+bool isaSupported(const Isa isa)
+{
+#if LINA_X86
+    __builtin_cpu_init();
+
+    switch (isa)
+    {
+        case ISA_SCALAR : return true;
+
+        case ISA_SSE2 : return __builtin_cpu_supports("sse2");
+
+        case ISA_AVX2 : return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+
+        case ISA_AVX512 : return __builtin_cpu_supports("avx512f");
+    }
+
+    return false;
+#else
+    return ISA_SCALAR == isa;
+#endif
+}
+
+//Use the kernels for |isa| from now on
+//Return false, leaving the current kernels in place, if the CPU does not support |isa|
+bool forceIsa(const Isa isa)
+{
+    if (!isaSupported(isa)) return false;
+
+    currentTable() = &TABLES[isa];
+    return true;
+}
+
+//Convert |name| (scalar, sse2, avx2, avx512) to its |Isa|
+//Return false if |name| is not an instruction set
+bool parseIsa(const std::string& name, Isa& isa)
+{
+    for (const KernelTable& table : TABLES)
+    {
+        if (name == table.name)
+        {
+            isa = table.isa;
+            return true;
+        }
+    }
+
+    return false;
+}
@@ -0,0 +1,86 @@
+/*
+The numeric kernels that every |Matrix| operation is built upon. Each kernel is implemented once per instruction set,
+and the fastest set supported by the host CPU is chosen the first time |kernels| is called, so one binary runs on every
+x86-64 host.
+
+INSTRUCTION SETS
+- SCALAR : portable C++, used on every other architecture
+- SSE2 : 128 bit vectors, the x86-64 baseline
+- AVX2 : 256 bit vectors with fused multiply-add
+- AVX512 : 512 bit vectors with fused multiply-add
+
+FORCING AN INSTRUCTION SET
+The environment variable LINA_ISA (scalar, sse2, avx2, avx512) overrides detection at startup, and |forceIsa| switches
+at runtime. Either is refused when the CPU does not support the requested set.
+
+@Sean Siders
+sean.siders@icloud.com
+*/
+
+#ifndef KERNELS_HPP_
+#define KERNELS_HPP_
+
+#include <cstddef>
+#include <string>
+
+//The instruction sets a kernel table can be built for, from slowest to fastest
+enum Isa
+{
+    ISA_SCALAR,
+    ISA_SSE2,
+    ISA_AVX2,
+    ISA_AVX512
+};
+
+//One complete set of kernels for a single instruction set
+struct KernelTable
+{
+    //The instruction set these kernels were compiled for
+    Isa isa;
+
+    //The name of |isa| for display
+    const char* name;
+
+    //y[i] += x[i] for |n| entries
+    void (*add)(double* y, const double* x, const size_t n);
+
+    //y[i] -= x[i] for |n| entries
+    void (*subtract)(double* y, const double* x, const size_t n);
+
+    //z[i] = x[i] + y[i] for |n| entries
+    void (*sum)(double* z, const double* x, const double* y, const size_t n);
+
+    //z[i] = x[i] - y[i] for |n| entries
+    void (*difference)(double* z, const double* x, const double* y, const size_t n);
+
+    //z[i] = x[i] * y[i] for |n| entries
+    void (*product)(double* z, const double* x, const double* y, const size_t n);
+
+    //z[i] = x[i] / y[i] for |n| entries
+    void (*quotient)(double* z, const double* x, const double* y, const size_t n);
+
+    //y[i] = a * x[i] for |n| entries, |y| may be |x|
+    void (*scale)(double* y, const double a, const double* x, const size_t n);
+
+    //y[i] += a * x[i] for |n| entries
+    void (*axpy)(double* y, const double a, const double* x, const size_t n);
+
+    //C += alpha * a * b for one |GEMM_MR| x |GEMM_NR| tile of C from packed micro-panels of depth |kc|
+    void (*microKernel)(const size_t kc, const double alpha, const double* a, const double* b, double* C, const size_t ldc);
+};
+
+//Return the kernel table in use, detecting the best instruction set on the first call
+const KernelTable& kernels();
+
+//True if the host CPU can run |isa|
+bool isaSupported(const Isa isa);
+
+//Use the kernels for |isa| from now on
+//Return false, leaving the current kernels in place, if the CPU does not support |isa|
+bool forceIsa(const Isa isa);
+
+//Convert |name| (scalar, sse2, avx2, avx512) to its |Isa|
+//Return false if |name| is not an instruction set
+bool parseIsa(const std::string& name, Isa& isa);
+
+#endif //KERNELS_HPP_
@@ -0,0 +1,208 @@
+/*
+@Sean Siders
+sean.siders@icloud.com
+*/
+
+#include "Lu.hpp"
+#include "Gemm.hpp"
+#include "Kernels.hpp"
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <cmath>
+
+//////// HELPERS
+
+//Y -= L * X, where L is |rows| x |depth|, X is |depth| x |columns| and Y is |rows| x |columns|
+//Large updates go through |gemm|, a few right-hand sides are updated directly without packing
+static void subtractProduct(const size_t rows, const size_t columns, const size_t depth,
+                            const double* L, const size_t ldl, const double* X, const size_t ldx, double* Y, const size_t ldy)
+{
+    if (gemmWorthwhile(rows, columns, depth))
+    {
+        gemm(rows, columns, depth, -1.0, L, ldl, X, ldx, 1.0, Y, ldy);
+        return;
+    }
+
+    for (size_t i = 0; i < rows; ++i)
+    {
+        for (size_t c = 0; c < columns; ++c)
+        {
+            double sum = 0.0;
+            for (size_t j = 0; j < depth; ++j) sum += L[i * ldl + j] * X[j * ldx + c];
+
+            Y[i * ldy + c] -= sum;
+        }
+    }
+}
+
+//////// CONSTRUCTORS
+
+//Factor the |order| x |order| row-major |buffer|, whose rows are |stride| entries apart
+LuFactorization::LuFactorization(const size_t order, const double* buffer, const size_t stride) :
+    order(order), factors(order * order), pivots(order), oddPermutation(false)
+{
+    for (size_t r = 0; r < order; ++r) std::copy(buffer + r * stride, buffer + r * stride + order, &factors[r * order]);
+
+    for (size_t k0 = 0; k0 < order; k0 += LU_BLOCK)
+    {
+        const size_t width = std::min(LU_BLOCK, order - k0);
+        const size_t next = k0 + width;
+
+        factorPanel(k0, width);
+
+        if (next < order)
+        {
+            solveBlockRow(k0, width);
+
+            //A22 -= L21 * U12
+            double* A = factors.data();
+            const size_t trailing = order - next;
+
+            gemm(trailing, trailing, width, -1.0, A + next * order + k0, order, A + k0 * order + next, order,
+                 1.0, A + next * order + next, order);
+        }
+    }
+}
+
+//////// PUBLIC FUNCTIONS
+
+//Return the determinant, the product of the diagonal of U with the sign of the row permutation
+double LuFactorization::determinant() const
+{
+    double determinant = oddPermutation ? -1.0 : 1.0;
+
+    for (size_t i = 0; i < order; ++i) determinant *= factors[i * order + i];
+
+    return determinant;
+}
+
+//True if U has a zero on its diagonal
+bool LuFactorization::singular() const
+{
+    for (size_t i = 0; i < order; ++i)
+        if (0.0 == factors[i * order + i]) return true;
+
+    return false;
+}
+
+//Overwrite the |order| x |columns| row-major |B|, whose rows are |ldb| entries apart, with the solution X of A * X = B
+//P * A = L * U, so the rows of B are permuted, then L * Y = P * B is solved forward and U * X = Y backward
+void LuFactorization::solve(double* B, const size_t columns, const size_t ldb) const
+{
+    const KernelTable& kernel = kernels();
+    const double* A = factors.data();
+
+    //P * B, the row swaps are replayed in the order they were made
+    for (size_t i = 0; i < order; ++i)
+        if (pivots[i] != i) std::swap_ranges(B + i * ldb, B + i * ldb + columns, B + pivots[i] * ldb);
+
+    //L * Y = P * B, top block first
+    for (size_t k0 = 0; k0 < order; k0 += LU_BLOCK)
+    {
+        const size_t next = std::min(k0 + LU_BLOCK, order);
+
+        //The unit lower triangle of the diagonal block
+        for (size_t i = k0 + 1; i < next; ++i)
+        {
+            for (size_t j = k0; j < i; ++j) kernel.axpy(B + i * ldb, -A[i * order + j], B + j * ldb, columns);
+        }
+
+        //Remove the solved block from every row below it, B2 -= L21 * Y1
+        if (next < order)
+        {
+            subtractProduct(order - next, columns, next - k0, A + next * order + k0, order, B + k0 * ldb, ldb,
+                            B + next * ldb, ldb);
+        }
+    }
+
+    //U * X = Y, bottom block first
+    const size_t blocks = (order + LU_BLOCK - 1) / LU_BLOCK;
+
+    for (size_t block = blocks; block-- > 0;)
+    {
+        const size_t k0 = block * LU_BLOCK;
+        const size_t next = std::min(k0 + LU_BLOCK, order);
+
+        //Remove every solved row below the block, Y1 -= U12 * X2
+        if (next < order)
+        {
+            subtractProduct(next - k0, columns, order - next, A + k0 * order + next, order, B + next * ldb, ldb,
+                            B + k0 * ldb, ldb);
+        }
+
+        //The upper triangle of the diagonal block, last row first
+        for (size_t i = next; i-- > k0;)
+        {
+            double* row = B + i * ldb;
+
+            for (size_t j = i + 1; j < next; ++j) kernel.axpy(row, -A[i * order + j], B + j * ldb, columns);
+
+            const double inverse = 1.0 / A[i * order + i];
+            for (size_t c = 0; c < columns; ++c) row[c] *= inverse;
+        }
+    }
+}
+
+//////// PRIVATE FUNCTIONS
+
+//Factor the |width| columns of the panel that begins at |k0|, swapping whole rows
+//Within the panel each column is eliminated from every row below it before the next column is pivoted
+void LuFactorization::factorPanel(const size_t k0, const size_t width)
+{
+    const KernelTable& kernel = kernels();
+    double* A = factors.data();
+    const size_t end = k0 + width;
+
+    for (size_t j = k0; j < end; ++j)
+    {
+        //The row with the largest entry in column |j| becomes the pivot row
+        size_t pivot = j;
+
+        for (size_t i = j + 1; i < order; ++i)
+            if (std::fabs(A[i * order + j]) > std::fabs(A[pivot * order + j])) pivot = i;
+
+        pivots[j] = pivot;
+
+        if (pivot != j)
+        {
+            std::swap_ranges(A + j * order, A + (j + 1) * order, A + pivot * order);
+            oddPermutation = !oddPermutation;
+        }
+
+        //Nothing is left to eliminate in this column
+        const double diagonal = A[j * order + j];
+        if (0.0 == diagonal) continue;
+
+        //Store the multipliers of L and eliminate the rest of the panel, each row independently
+        const double* pivotRow = A + j * order;
+        const size_t rows = order - j - 1;
+        const size_t columns = end - j - 1;
+
+        parallelFor(rows, rows * (columns + 1), [&](size_t begin, size_t last)
+        {
+            for (size_t i = j + 1 + begin; i < j + 1 + last; ++i)
+            {
+                double* row = A + i * order;
+                row[j] /= diagonal;
+
+                if (columns) kernel.axpy(row + j + 1, -row[j], pivotRow + j + 1, columns);
+            }
+        });
+    }
+}
+
+//Solve the block row of U to the right of the panel that begins at |k0|
+//U12 = inverse(L11) * A12, by forward substitution with the unit lower triangle of the panel
+void LuFactorization::solveBlockRow(const size_t k0, const size_t width)
+{
+    const KernelTable& kernel = kernels();
+    double* A = factors.data();
+    const size_t next = k0 + width;
+    const size_t columns = order - next;
+
+    for (size_t j = k0; j < next; ++j)
+    {
+        for (size_t i = j + 1; i < next; ++i)
+            kernel.axpy(A + i * order + next, -A[i * order + j], A + j * order + next, columns);
+    }
+}
@@ -0,0 +1,95 @@
+/*
+LU factorization with partial pivoting, P * A = L * U, for square matrices. L is unit lower triangular and U is upper
+triangular, both are stored in place of A in a single buffer (the unit diagonal of L is implied).
+
+BLOCKING
+The factorization is right-looking and blocked by |LU_BLOCK| columns:
+- The panel of |LU_BLOCK| columns is factored one column at a time, with the row of the largest entry in the column
+  swapped into the pivot position
+- The block row of U to the right of the panel is solved with the unit lower triangle of the panel
+- The trailing matrix is updated with a single |gemm| call, A22 -= L21 * U12, which is cache-blocked and split across
+  the thread pool
+Almost every floating point operation is in the trailing update, so large factorizations run at |gemm| speed.
+
+SOLVING
+|solve| overwrites a block of right-hand sides B with the solution X of A * X = B. Every column of B is solved at once,
+block by block: each diagonal block is a small triangular solve, and the rest of B is updated with a single |gemm| call,
+so solving for many right-hand sides runs at the speed of a matrix product rather than as a loop of vector solves.
+
+INVERSE
+The inverse of A solves A * X = I with |solve|, written straight into the buffer that becomes the inverse.
+
+SINGULAR MATRICES
+A column with no nonzero pivot is skipped, the factorization still completes and |singular| is true. Matrices that are
+only nearly singular are caught by their condition number, compared against |LU_CONDITION_LIMIT|.
+
+|Matrix| caches its factorization until its entries change, see |Matrix::factorization|.
+
+@Sean Siders
+sean.siders@icloud.com
+*/
+
+#ifndef LU_HPP_
+#define LU_HPP_
+
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+//The number of columns in each panel of the blocked factorization
+const size_t LU_BLOCK = 64;
+
+//A matrix whose condition number exceeds this is numerically singular, its inverse would have no correct digits
+const double LU_CONDITION_LIMIT = 1.0 / std::numeric_limits<double>::epsilon();
+
+class LuFactorization
+{
+    public:
+    //////// CONSTRUCTORS
+
+    //Factor the |order| x |order| row-major |buffer|, whose rows are |stride| entries apart
+    LuFactorization(const size_t order, const double* buffer, const size_t stride);
+
+    //////// PUBLIC FUNCTIONS
+
+    //Return the determinant, the product of the diagonal of U with the sign of the row permutation
+    double determinant() const;
+
+    //True if U has a zero on its diagonal
+    bool singular() const;
+
+    //Overwrite the |order| x |columns| row-major |B|, whose rows are |ldb| entries apart, with the solution X of A * X = B
+    //The factorization must not be |singular|
+    void solve(double* B, const size_t columns, const size_t ldb) const;
+
+    //////// GETTERS
+
+    size_t _order() const { return order; }
+
+    //The combined L and U factors, row-major with rows |_order| entries apart
+    const double* _factors() const { return factors.data(); }
+
+    //Row i of the factored matrix was swapped with row |_pivots()[i]|, in order of i
+    const size_t* _pivots() const { return pivots.data(); }
+
+    private:
+    //The number of rows and columns of the factored matrix
+    size_t order;
+
+    //L below the diagonal and U on and above it
+    std::vector<double> factors;
+
+    //The row swapped into each pivot position
+    std::vector<size_t> pivots;
+
+    //True if an odd number of rows were swapped
+    bool oddPermutation;
+
+    //Factor the |width| columns of the panel that begins at |k0|, swapping whole rows
+    void factorPanel(const size_t k0, const size_t width);
+
+    //Solve the block row of U to the right of the panel that begins at |k0|
+    void solveBlockRow(const size_t k0, const size_t width);
+};
+
+#endif //LU_HPP_
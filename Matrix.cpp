@@ -1,4 +1,19 @@
 #include "Matrix.hpp"
+#include "Fixed.hpp"
+#include "Gemm.hpp"
+#include "Kernels.hpp"
+#include "Lu.hpp"
+#include "Qr.hpp"
+#include "Sparse.hpp"
+#include "Strassen.hpp"
+#include "ThreadPool.hpp"
+#include "Transpose.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <vector>
 
 void Matrix::debugDisplay() const
 {
@@ -7,7 +22,7 @@ void Matrix::debugDisplay() const
     for (size_t r = 0; r < rows; ++r)
     {
         for (size_t c = 0; c < columns; ++c)
-            std::cout << matrix[r][c] << ' ';
+            std::cout << (sparse ? sparse->entry(r, c) : at(r, c)) << ' ';
 
         std::cout << '\n';
     }
@@ -49,195 +64,292 @@ bool Matrix::operator>(const std::string& rhs) const
 
 Matrix& Matrix::operator=(const Matrix& rhs)
 {
-    if (this != &rhs) copy(rhs);
+    if (this != &rhs) overwrite(rhs);
 
     return *this;
 }
 
-Matrix Matrix::operator+(const Matrix& rhs) const
+//Take ownership of the buffer of |rhs|, leaving |rhs| empty
+Matrix& Matrix::operator=(Matrix&& rhs) noexcept
 {
-    //Make a copy of this matrix
-    Matrix result(*this);
-
-    //Add |rhs|
-    result += rhs;
+    if (this != &rhs)
+    {
+        clearMatrix();
+        identifier = std::move(rhs.identifier);
+        take(std::move(rhs));
+    }
 
-    return result;
+    return *this;
 }
 
 Matrix& Matrix::operator+=(const Matrix& rhs)
 {
-    //Reset the matrix string
-    matrixString.clear();
-
-    for (size_t r = 0; r < rows; ++r)
-    {
-        for (size_t c = 0; c < columns; ++c)
-        {
-            matrix[r][c] += rhs.matrix[r][c];
-
-            //Append entry to the string
-            matrixString += std::to_string(matrix[r][c]);
-
-            //If this is the last column, add a newline to the string
-            //Otherwise add a space
-            matrixString += (1 + c == columns) ? '\n' : ' ';
-        }
-    }
-
+    accumulate(rhs, false);
     return *this;
 }
 
-Matrix Matrix::operator-(const Matrix& rhs) const
+Matrix& Matrix::operator-=(const Matrix& rhs)
 {
-    //Make a copy of this matrix
-    Matrix result(*this);
-
-    //Subtract |rhs|
-    result -= rhs;
-
-    return result;
+    accumulate(rhs, true);
+    return *this;
 }
 
-Matrix& Matrix::operator-=(const Matrix& rhs)
+//Add |rhs| to this matrix, or subtract it when |subtract|
+void Matrix::accumulate(const Matrix& rhs, const bool subtract)
 {
-    //Reset the matrix string
-    matrixString.clear();
+    //The entries are about to change, the matrix string and factorizations are stale
+    invalidateString();
+    lu.reset();
+    qr.reset();
 
-    for (size_t r = 0; r < rows; ++r)
+    //Two sparse matrices are merged without ever being expanded
+    //The sum may have filled in enough to be stored dense
+    if (sparse && rhs.sparse)
     {
-        for (size_t c = 0; c < columns; ++c)
-        {
-            matrix[r][c] -= rhs.matrix[r][c];
+        *sparse = sparseSum(*sparse, *rhs.sparse, subtract);
+        adaptStorage();
+        return;
+    }
 
-            //Append entry to the string
-            matrixString += std::to_string(matrix[r][c]);
+    //A sparse matrix plus a dense matrix is dense
+    if (sparse) densify();
 
-            //If this is the last column, add a newline to the string
-            //Otherwise add a space
-            matrixString += (1 + c == columns) ? '\n' : ' ';
-        }
+    //Only the nonzero entries of a sparse |rhs| are visited
+    if (rhs.sparse)
+    {
+        rhs.sparse->scatter(matrix, stride, subtract);
+        return;
     }
 
-    return *this;
+    //Tiny square matrices are combined with unrolled code of their exact order
+    if (fixedWorthwhile(rows, columns, columns))
+    {
+        fixedCombine(rows, matrix, stride, rhs.matrix, rhs.stride, subtract);
+        return;
+    }
+
+    //Matrices of the same order share a |stride| and their row padding is zero
+    //Each block of rows is one contiguous vector operation
+    //Large matrices are split into row blocks across the thread pool
+    const KernelTable& kernel = kernels();
+
+    parallelFor(rows, rows * stride, [&](size_t begin, size_t end)
+    {
+        if (subtract) kernel.subtract(matrix + begin * stride, rhs.matrix + begin * stride, (end - begin) * stride);
+        else kernel.add(matrix + begin * stride, rhs.matrix + begin * stride, (end - begin) * stride);
+    });
 }
 
 Matrix Matrix::operator*(const Matrix& rhs) const
 {
-    //Make a copy of this matrix
-    Matrix result(*this);
+    //The product of two sparse matrices is built sparse
+    if (sparse && rhs.sparse) return Matrix(identifier, sparseSparse(*sparse, *rhs.sparse));
 
-    //Multiply with |rhs|
-    result *= rhs;
+    //Write the product straight into a new matrix, |this| is never copied
+    Matrix product(identifier, rows, rhs.columns);
+    multiply(rhs, product);
 
-    return result;
+    return product;
 }
 
 Matrix& Matrix::operator*=(const Matrix& rhs)
 {
-    //Reset the matrix string
-    matrixString.clear();
+    Matrix product = *this * rhs;
 
-    //Get product matrix and reassign |matrix|
-    matrix = multiply(rhs);
+    //Adopt the product buffer, the old buffer is released with |product|
+    clearMatrix();
+    take(std::move(product));
 
     return *this;
 }
 
-//Multiply the current |matrix| with |other| as a |product| matrix
-//Simultaneously deallocate |matrix| and modify |matrixString|
-//Return the |product| matrix
-double** Matrix::multiply(const Matrix& rhs)
+//Multiply every entry by |scalar| in place, a sparse matrix scales only its nonzero entries
+Matrix& Matrix::operator*=(const double scalar)
 {
-    //Make a new matrix with the new order
-    double** product = new double*[rows];
-
-    //Get the column magnitude for the product matrix
-    size_t newColumns = rhs.columns;
+    if (sparse) sparse->scale(scalar);
 
-    //To hold the product sum of each traversal
-    double productSum = 0.0;
-
-    //Traverse the rows of this matrix
-    for (size_t r = 0; r < rows; ++r)
+    else
     {
-        //Allocate product matrix row
-        product[r] = new double[newColumns];
+        const KernelTable& kernel = kernels();
 
-        //Traverse the columns of |rhs|
-        for (size_t i = 0; i < newColumns; ++i)
+        parallelFor(rows, rows * columns, [&](size_t begin, size_t end)
         {
-            productSum = 0.0;
+            for (size_t r = begin; r < end; ++r) kernel.scale(matrix + r * stride, scalar, matrix + r * stride, columns);
+        });
+    }
 
-            //Traverse the columns of this matrix and rows of |rhs|
-            for (size_t j = 0; j < columns; ++j)
-            {
-                //Sum the product of columns of this matrix and rows of |rhs|
-                productSum += matrix[r][j] * rhs.matrix[j][i];
-            }
+    invalidateString();
+    lu.reset();
+    qr.reset();
 
-            product[r][i] = productSum;
+    return *this;
+}
 
-            //Append entry to the string
-            matrixString += std::to_string(product[r][i]);
+//Multiply this matrix with |rhs|, writing the result into the zeroed dense |product|
+//|product| must already be allocated to |rows| x |rhs.columns|
+//At most one of this matrix and |rhs| may be sparse
+void Matrix::multiply(const Matrix& rhs, Matrix& product) const
+{
+    //A sparse operand only contributes its nonzero entries
+    if (sparse) sparseDense(*sparse, rhs.matrix, rhs.stride, rhs.columns, product.matrix, product.stride);
 
-            //If this is the last column, add a newline to the string
-            //Otherwise add a space
-            matrixString += (1 + i == newColumns) ? '\n' : ' ';
-        }
+    else if (rhs.sparse) denseSparse(rows, matrix, stride, *rhs.sparse, product.matrix, product.stride);
+
+    //Tiny square products are computed with unrolled code of their exact order
+    else if (fixedWorthwhile(rows, rhs.columns, columns))
+        fixedMultiply(rows, matrix, stride, rhs.matrix, rhs.stride, product.matrix, product.stride);
 
-        //Dellocate row
-        delete [] matrix[r];
-        matrix[r] = nullptr;
+    //Very large products may take the Strassen-Winograd recursion, when it is enabled
+    else if (strassenWorthwhile(rows, rhs.columns, columns))
+    {
+        strassen(rows, rhs.columns, columns, matrix, stride, rhs.matrix, rhs.stride, product.matrix, product.stride,
+                 strassenSettings().crossover);
     }
 
-    //Set the new columns
-    columns = newColumns;
+    //Large products go through the cache-blocked engine
+    else if (gemmWorthwhile(rows, rhs.columns, columns))
+    {
+        gemm(rows, rhs.columns, columns, 1.0, matrix, stride, rhs.matrix, rhs.stride, 0.0, product.matrix, product.stride);
+    }
 
-    //Deallocate the old matrix
-    delete [] matrix;
-    matrix = nullptr;
+    //Small products are computed directly, traversing the rows of this matrix
+    else
+    {
+        const KernelTable& kernel = kernels();
 
-    return product;
+        for (size_t r = 0; r < rows; ++r)
+        {
+            double* productRow = product.matrix + r * product.stride;
+
+            //Traverse the columns of this matrix and rows of |rhs|
+            //Each row of |rhs| is walked contiguously, every product entry still sums in order of |j|
+            //The freshly allocated |product| row starts at zero
+            for (size_t j = 0; j < columns; ++j)
+                kernel.axpy(productRow, at(r, j), rhs.matrix + j * rhs.stride, rhs.columns);
+        }
+    }
 }
 
-Matrix::Matrix() : rows(0), columns(0), matrix(nullptr) {}
+Matrix::Matrix() : rows(0), columns(0), stride(0), matrix(nullptr), sparse(nullptr), stringValid(true) {}
 
-Matrix::Matrix(const Matrix& source)
+Matrix::Matrix(const Matrix& source) :
+    rows(0), columns(0), stride(0), matrix(nullptr), sparse(nullptr), stringValid(true)
 {
     copy(source);
 }
 
-Matrix::Matrix(const Matrix& source, const std::string& identifier) : identifier(identifier)
+//Take ownership of the buffer of |source|, leaving |source| empty
+Matrix::Matrix(Matrix&& source) noexcept :
+    identifier(std::move(source.identifier)), rows(0), columns(0), stride(0), matrix(nullptr), sparse(nullptr),
+    stringValid(true)
+{
+    take(std::move(source));
+}
+
+//Take ownership of the buffer of |source| under a new |identifier|
+Matrix::Matrix(Matrix&& source, const std::string& identifier) noexcept :
+    identifier(identifier), rows(0), columns(0), stride(0), matrix(nullptr), sparse(nullptr), stringValid(true)
+{
+    take(std::move(source));
+}
+
+//Allocate a zeroed |rows| x |columns| matrix, for the result of an operation
+Matrix::Matrix(const std::string& identifier, const size_t rows, const size_t columns) :
+    identifier(identifier), rows(rows), columns(columns), stride(strideFor(columns)), matrix(nullptr), sparse(nullptr),
+    stringValid(false)
+{
+    matrix = allocate(rows, stride);
+}
+
+//Take the sparse |entries| as the matrix, stored sparse or dense as |adaptStorage| decides
+Matrix::Matrix(const std::string& identifier, SparseMatrix&& entries) :
+    identifier(identifier), rows(entries._rows()), columns(entries._columns()), stride(0), matrix(nullptr),
+    sparse(new SparseMatrix(std::move(entries))), stringValid(false)
+{
+    adaptStorage();
+}
+
+//Copy the |rows| x |columns| row-major |buffer|, whose rows are |stride| entries apart
+Matrix::Matrix(const std::string& identifier, const double* buffer, const size_t rows, const size_t columns,
+               const size_t stride) :
+    Matrix(identifier, rows, columns)
+{
+    for (size_t r = 0; r < rows; ++r) std::memcpy(matrix + r * this->stride, buffer + r * stride, columns * sizeof(double));
+}
+
+Matrix::Matrix(const Matrix& source, const std::string& identifier) :
+    identifier(identifier), rows(0), columns(0), stride(0), matrix(nullptr), sparse(nullptr), stringValid(true)
 {
     matrixString = source.matrixString;
+    stringValid = source.stringValid;
     rows = source.rows;
     columns = source.columns;
 
     copyMatrix(source);
 }
 
-Matrix::Matrix(std::ifstream& inFile)
+Matrix::Matrix(std::ifstream& inFile) :
+    rows(0), columns(0), stride(0), matrix(nullptr), sparse(nullptr), stringValid(true)
 {
     //Read in the data
     inFile >> identifier;
     inFile >> rows;
     inFile >> columns;
 
-    //Ignore the newline after the first 3 entries
-    inFile.ignore(1, '\n');
+    //The rest of the header line is empty for a dense matrix
+    //A sparse matrix is followed by a tag and its number of nonzero entries
+    //Each nonzero entry is then on its own line as : row column value
+    std::string header;
+    getline(inFile, header);
+
+    std::istringstream headerStream(header);
+    std::string tag;
+    size_t nonzeros = 0;
+
+    if (headerStream >> tag && "sparse" == tag)
+    {
+        headerStream >> nonzeros;
+
+        sparse = new SparseMatrix(rows, columns);
+        stringValid = false;
+
+        size_t r = 0;
+        size_t c = 0;
+        double value = 0.0;
+
+        //The row being built
+        size_t row = 0;
+
+        //Entries are written in order of row then column, rows without an entry are closed as they are passed
+        for (size_t i = 0; i < nonzeros && inFile >> r >> c >> value; ++i)
+        {
+            for (; row < r; ++row) sparse->endRow();
+            sparse->append(c, value);
+        }
+
+        for (; row < rows; ++row) sparse->endRow();
+
+        //Skip past the '#' that ends the matrix
+        inFile.ignore(std::numeric_limits<std::streamsize>::max(), '#');
+        return;
+    }
 
     //Read in the matrix
     getline(inFile, matrixString, '#');
+    stringValid = true;
 
     std::istringstream stream(matrixString);
     readIn(stream);
+
+    //Matrices saved dense that are mostly zeros are stored sparse from now on
+    adaptStorage();
 }
 
 //Allocate |matrix| to the dimensions supplied with |rows| and |columns|
 //Populate the |matrix| with the numeric entries in |matrixString|
 Matrix::Matrix(const std::string& identifier, const std::string& matrixString, const size_t& rows, const size_t& columns) :
-    identifier(identifier), matrixString(matrixString), rows(rows), columns(columns), matrix(nullptr)
+    identifier(identifier), matrixString(matrixString), rows(rows), columns(columns), stride(0), matrix(nullptr),
+    sparse(nullptr), stringValid(true)
 {
     std::istringstream stream(matrixString);
     readIn(stream);
@@ -251,7 +363,7 @@ Matrix::~Matrix()
 //Display the matrix |identifier| followed by the |matrixString|
 void Matrix::display(std::ostream& out) const
 {
-    out << '\"' << identifier << "\"\n" << matrixString;
+    out << '\"' << identifier << "\"\n" << text();
 }
 
 //Display only the matrix |identifier|
@@ -267,39 +379,151 @@ void Matrix::overwrite(const Matrix& source)
     copy(source);
 }
 
+//Clear the current matrix and take ownership of the buffer of |source|
+void Matrix::overwrite(Matrix&& source)
+{
+    clear();
+
+    identifier = std::move(source.identifier);
+    take(std::move(source));
+}
+
+void Matrix::overwrite(Matrix&& source, const std::string& newIdentifier)
+{
+    clear();
+
+    identifier = newIdentifier;
+    take(std::move(source));
+}
+
 void Matrix::overwrite(const Matrix& source, const std::string& newIdentifier)
 {
     clear();
 
     identifier = newIdentifier;
     matrixString = source.matrixString;
+    stringValid = source.stringValid;
     rows = source.rows;
     columns = source.columns;
 
     copyMatrix(source);
 }
 
+//Return the |stride| for a row of |columns| entries
+//Rows narrower than one cache line are left unpadded
+size_t Matrix::strideFor(const size_t columns)
+{
+    const size_t lineEntries = ALIGNMENT / sizeof(double);
+
+    if (columns < lineEntries) return columns;
+
+    return (columns + lineEntries - 1) / lineEntries * lineEntries;
+}
+
+//Allocate an aligned buffer of |rows| x |stride| entries, return null if the buffer would be empty
+//Row padding is zeroed so that it never holds uninitialized values
+double* Matrix::allocate(const size_t rows, const size_t stride)
+{
+    if (!rows || !stride) return nullptr;
+
+    const size_t bytes = rows * stride * sizeof(double);
+    double* buffer = static_cast<double*>(::operator new[](bytes, std::align_val_t(ALIGNMENT)));
+    std::memset(buffer, 0, bytes);
+
+    return buffer;
+}
+
+//Deallocate a |buffer| returned by |allocate|
+void Matrix::deallocate(double* buffer)
+{
+    if (buffer) ::operator delete[](buffer, std::align_val_t(ALIGNMENT));
+}
+
 //Allocate the |matrix| to the dimensions of |rows| x |columns|
 //Read in entries from the provided |stream|
 void Matrix::readIn(std::istream& stream)
 {
     double entry = 0.0;
-    matrix = new double*[rows];
+    stride = strideFor(columns);
+    matrix = allocate(rows, stride);
+
     for (size_t r = 0; r < rows; ++r)
     {
-        matrix[r] = new double[columns];
         for (size_t c = 0; c < columns; ++c)
         {
             stream >> entry;
-            matrix[r][c] = entry;
+            at(r, c) = entry;
         }
     }
 }
 
 //Write the contents of of this matrix out to |outFile|
+//A sparse matrix writes only its nonzero entries, one per line as : row column value
 void Matrix::writeFile(std::ofstream& outFile) const
 {
-    outFile << identifier <<  ' ' << rows << ' ' << columns << '\n' << matrixString << '#';
+    outFile << identifier <<  ' ' << rows << ' ' << columns;
+
+    if (sparse)
+    {
+        outFile << " sparse " << sparse->_nonzeros() << '\n';
+
+        const size_t* column = sparse->_columnIndex();
+        const double* value = sparse->_values();
+
+        //Every value is written with enough digits to be read back exactly, small nonzeros must not round to 0
+        const std::streamsize precision = outFile.precision(std::numeric_limits<double>::max_digits10);
+
+        for (size_t r = 0; r < rows; ++r)
+        {
+            for (size_t i = sparse->_rowBegin(r); i < sparse->_rowEnd(r); ++i)
+                outFile << r << ' ' << column[i] << ' ' << value[i] << '\n';
+        }
+
+        outFile.precision(precision);
+        outFile << '#';
+    }
+
+    else outFile << '\n' << text() << '#';
+}
+
+//Return the |matrixString|, formatting it from the entries of |matrix| only if it is stale
+const std::string& Matrix::text() const
+{
+    if (stringValid) return matrixString;
+
+    matrixString.clear();
+
+    //The next nonzero entry of a sparse matrix
+    size_t next = 0;
+
+    for (size_t r = 0; r < rows; ++r)
+    {
+        for (size_t c = 0; c < columns; ++c)
+        {
+            double entry = 0.0;
+
+            //The nonzero entries of a sparse row are in order of column
+            if (!sparse) entry = at(r, c);
+            else if (next < sparse->_rowEnd(r) && c == sparse->_columnIndex()[next]) entry = sparse->_values()[next++];
+
+            //Append entry to the string
+            matrixString += std::to_string(entry);
+
+            //If this is the last column, add a newline to the string
+            //Otherwise add a space
+            matrixString += (1 + c == columns) ? '\n' : ' ';
+        }
+    }
+
+    stringValid = true;
+    return matrixString;
+}
+
+//Mark the |matrixString| as stale, it will be rebuilt by the next call to |text|
+void Matrix::invalidateString()
+{
+    matrixString.clear();
+    stringValid = false;
 }
 
 //Make a copy of |source| into this matrix
@@ -307,23 +531,48 @@ void Matrix::copy(const Matrix& source)
 {
     identifier = source.identifier;
     matrixString = source.matrixString;
+    stringValid = source.stringValid;
     rows = source.rows;
     columns = source.columns;
 
     copyMatrix(source);
 }
 
-//Copy the |matrix| from |source|
+//Take the |matrix|, its order and the |matrixString| from |source|, leaving |source| empty
+//The current |matrix| must already be deallocated
+void Matrix::take(Matrix&& source)
+{
+    matrixString = std::move(source.matrixString);
+    stringValid = source.stringValid;
+    rows = source.rows;
+    columns = source.columns;
+    stride = source.stride;
+    matrix = source.matrix;
+    sparse = source.sparse;
+    lu = std::move(source.lu);
+    qr = std::move(source.qr);
+
+    source.matrixString.clear();
+    source.stringValid = true;
+    source.rows = 0;
+    source.columns = 0;
+    source.stride = 0;
+    source.matrix = nullptr;
+    source.sparse = nullptr;
+}
+
+//Copy the |matrix|, or the |sparse| entries, from |source|
+//Both buffers share the same |stride|, so the copy is a single block transfer
 void Matrix::copyMatrix(const Matrix& source)
 {
-    matrix = new double*[rows];
-    for (size_t r = 0; r < rows; ++r)
-    {
-        matrix[r] = new double[columns];
+    if (source.sparse) sparse = new SparseMatrix(*source.sparse);
+    lu = source.lu;
+    qr = source.qr;
 
-        for (size_t c = 0; c < columns; ++c)
-            matrix[r][c] = source.matrix[r][c];
-    }
+    stride = source.stride;
+    matrix = allocate(rows, stride);
+
+    if (matrix) std::memcpy(matrix, source.matrix, rows * stride * sizeof(double));
 }
 
 //Set all members to initial values
@@ -332,23 +581,382 @@ void Matrix::clear()
 {
     identifier.clear();
     matrixString.clear();
+    stringValid = true;
     clearMatrix();
 }
 
 //Deallocate the |matrix| and set to null
 void Matrix::clearMatrix()
 {
-    for (size_t r = 0; r < rows; ++r)
+    rows = 0;
+    columns = 0;
+    stride = 0;
+
+    deallocate(matrix);
+    matrix = nullptr;
+
+    delete sparse;
+    sparse = nullptr;
+
+    lu.reset();
+    qr.reset();
+}
+
+//Store the matrix sparse if |sparseWorthwhile| holds for its nonzero entries, otherwise store it dense
+void Matrix::adaptStorage()
+{
+    const size_t nonzeros = sparse ? sparse->_nonzeros() : countNonzeros(rows, columns, matrix, stride);
+    const bool worthwhile = sparseWorthwhile(rows, columns, nonzeros);
+
+    if (worthwhile && !sparse) compress();
+    else if (!worthwhile && sparse) densify();
+}
+
+//Store the matrix dense, for operations that only have a dense implementation
+void Matrix::densify()
+{
+    if (!sparse) return;
+
+    stride = strideFor(columns);
+    matrix = allocate(rows, stride);
+    sparse->expand(matrix, stride);
+
+    delete sparse;
+    sparse = nullptr;
+}
+
+//Return this matrix if it is dense, otherwise a dense copy of it expanded into |scratch|
+const Matrix& Matrix::dense(Matrix& scratch) const
+{
+    if (!sparse) return *this;
+
+    scratch = *this;
+    scratch.densify();
+
+    return scratch;
+}
+
+//Return the LU factorization of this square matrix, see |Lu.hpp|
+//The factorization is cached, it is only computed again once the entries of the matrix change
+const LuFactorization& Matrix::factorization() const
+{
+    if (lu) return *lu;
+
+    //The factors are always dense, a sparse matrix is expanded first
+    if (sparse)
     {
-        delete [] matrix[r];
-        matrix[r] = nullptr;
+        std::vector<double> entries(rows * columns, 0.0);
+        sparse->expand(entries.data(), columns);
+
+        lu = std::make_shared<const LuFactorization>(rows, entries.data(), columns);
     }
 
-    rows = 0;
-    columns = 0;
-    
-    delete [] matrix;
+    else lu = std::make_shared<const LuFactorization>(rows, matrix, stride);
+
+    return *lu;
+}
+
+//Return X, the solution of this * X = |rhs|, named after |rhs|
+//Every column of |rhs| is solved at once with the cached |factorization|
+Matrix Matrix::solve(const Matrix& rhs) const
+{
+    //The copy carries the cached factorizations of |rhs|, which no longer hold once it is overwritten
+    Matrix solution(rhs);
+    solution.densify();
+    solution.invalidateString();
+    solution.lu.reset();
+    solution.qr.reset();
+
+    factorization().solve(solution.matrix, solution.columns, solution.stride);
+
+    return solution;
+}
+
+//Return the inverse of this matrix, computed with the cached |factorization| in the buffer of the result
+//The result begins as the identity and is overwritten with the solution of this * X = I
+Matrix Matrix::inverse() const
+{
+    Matrix result(identifier, rows, columns);
+
+    for (size_t i = 0; i < rows; ++i) result.at(i, i) = 1.0;
+
+    factorization().solve(result.matrix, result.columns, result.stride);
+
+    return result;
+}
+
+//Return the QR factorization of this matrix, see |Qr.hpp|
+//The factorization is cached, it is only computed again once the entries of the matrix change
+const QrFactorization& Matrix::qrFactorization() const
+{
+    if (qr) return *qr;
+
+    //The factors are always dense, a sparse matrix is expanded first
+    if (sparse)
+    {
+        std::vector<double> entries(rows * columns, 0.0);
+        sparse->expand(entries.data(), columns);
+
+        qr = std::make_shared<const QrFactorization>(rows, columns, entries.data(), columns);
+    }
+
+    else qr = std::make_shared<const QrFactorization>(rows, columns, matrix, stride);
+
+    return *qr;
+}
+
+//Return the first min(|rows|, |columns|) columns of Q from the cached |qrFactorization|, named |name|
+Matrix Matrix::orthogonalFactor(const std::string& name) const
+{
+    const QrFactorization& factors = qrFactorization();
+
+    Matrix result(name, rows, factors._reflectors());
+    factors.formQ(result.matrix, result.stride);
+
+    return result;
+}
+
+//Return R from the cached |qrFactorization|, named |name|
+Matrix Matrix::triangularFactor(const std::string& name) const
+{
+    const QrFactorization& factors = qrFactorization();
+
+    Matrix result(name, factors._reflectors(), columns);
+    factors.formR(result.matrix, result.stride);
+
+    return result;
+}
+
+//Return X, the least squares solution of this * X = |rhs|, named after |rhs|
+//Q' is applied to a dense copy of |rhs|, whose first |columns| rows then hold X once R is solved
+Matrix Matrix::leastSquares(const Matrix& rhs) const
+{
+    Matrix work(rhs);
+    work.densify();
+
+    qrFactorization().leastSquares(work.matrix, work.columns, work.stride);
+
+    return Matrix(rhs.identifier, work.matrix, columns, rhs.columns, work.stride);
+}
+
+//Return the largest sum of the absolute values of the entries in any column
+double Matrix::oneNorm() const
+{
+    std::vector<double> sums(columns, 0.0);
+
+    if (sparse)
+    {
+        for (size_t i = 0; i < sparse->_nonzeros(); ++i) sums[sparse->_columnIndex()[i]] += std::fabs(sparse->_values()[i]);
+    }
+
+    else
+    {
+        for (size_t r = 0; r < rows; ++r)
+            for (size_t c = 0; c < columns; ++c) sums[c] += std::fabs(at(r, c));
+    }
+
+    double norm = 0.0;
+    for (const double sum : sums) norm = std::max(norm, sum);
+
+    return norm;
+}
+
+//Return the transpose of this matrix, named after this matrix
+Matrix Matrix::transposed() const
+{
+    if (sparse) return Matrix(identifier, sparseTranspose(*sparse));
+
+    Matrix result(identifier, columns, rows);
+    transposeCopy(rows, columns, matrix, stride, result.matrix, result.stride);
+
+    return result;
+}
+
+//Transpose this matrix, a dense square matrix is transposed within its own buffer
+//Any other matrix is replaced with its transpose
+void Matrix::transpose()
+{
+    if (matrix && rows == columns) transposeSquare(rows, matrix, stride);
+
+    else
+    {
+        Matrix result = transposed();
+
+        clearMatrix();
+        take(std::move(result));
+    }
+
+    invalidateString();
+    lu.reset();
+    qr.reset();
+}
+
+//Return op(this) * op(|rhs|), where op transposes its operand when |lhsTransposed| or |rhsTransposed| is set
+//Large dense products pass the flags to |gemm|, which reads the transposed operand as it packs it
+//Sparse and small products form the transpose, at a cost far below the product itself, and multiply as usual
+Matrix Matrix::multiplyTransposed(const Matrix& rhs, const bool lhsTransposed, const bool rhsTransposed) const
+{
+    const size_t m = lhsTransposed ? columns : rows;
+    const size_t k = lhsTransposed ? rows : columns;
+    const size_t n = rhsTransposed ? rhs.rows : rhs.columns;
+
+    if (!lhsTransposed && !rhsTransposed) return *this * rhs;
+
+    if (sparse || rhs.sparse || !gemmWorthwhile(m, n, k))
+    {
+        if (!lhsTransposed) return *this * rhs.transposed();
+        if (!rhsTransposed) return transposed() * rhs;
+
+        return transposed() * rhs.transposed();
+    }
+
+    Matrix product(identifier, m, n);
+    gemm(lhsTransposed, rhsTransposed, m, n, k, 1.0, matrix, stride, rhs.matrix, rhs.stride, 0.0,
+         product.matrix, product.stride);
+
+    return product;
+}
+
+//Return the elementwise product of this matrix and |rhs|, or the elementwise quotient when |divide|, named after this
+//matrix
+//A product with a sparse operand is built sparse from its nonzero entries, any other result is computed dense a row at
+//a time, only the |columns| entries of each row, so the zeroed row padding is never divided
+Matrix Matrix::hadamard(const Matrix& rhs, const bool divide) const
+{
+    if (!divide && sparse && rhs.sparse) return Matrix(identifier, sparseHadamard(*sparse, *rhs.sparse));
+    if (!divide && sparse) return Matrix(identifier, sparseHadamard(*sparse, rhs.matrix, rhs.stride));
+    if (!divide && rhs.sparse) return Matrix(identifier, sparseHadamard(*rhs.sparse, matrix, stride));
+
+    //A quotient reads every entry, sparse operands are expanded into dense copies
+    Matrix lhsScratch;
+    Matrix rhsScratch;
+    const Matrix* lhs = &dense(lhsScratch);
+    const Matrix* other = &rhs.dense(rhsScratch);
+
+    Matrix result(identifier, rows, columns);
+    const KernelTable& kernel = kernels();
+
+    parallelFor(rows, rows * columns, [&](size_t begin, size_t end)
+    {
+        for (size_t r = begin; r < end; ++r)
+        {
+            double* out = result.matrix + r * result.stride;
+            const double* x = lhs->matrix + r * lhs->stride;
+            const double* y = other->matrix + r * other->stride;
+
+            if (divide) kernel.quotient(out, x, y, columns);
+            else kernel.product(out, x, y, columns);
+        }
+    });
+
+    return result;
+}
+
+//Return the Kronecker product of this matrix and |rhs|, named after this matrix
+//Row i * |rhs.rows| + r of the product is row r of |rhs| scaled by each entry of row i of this matrix in turn, every
+//scaled copy is a single kernel call and the rows of the product are split across the thread pool
+//The product of a sparse operand has the nonzeros of both multiplied, it is built sparse
+Matrix Matrix::kronecker(const Matrix& rhs) const
+{
+    if (sparse || rhs.sparse)
+    {
+        //A dense operand is compressed, the product is no denser than the sparse operand
+        const SparseMatrix lhsEntries = sparse ? *sparse : SparseMatrix(rows, columns, matrix, stride);
+        const SparseMatrix rhsEntries = rhs.sparse ? *rhs.sparse :
+                                        SparseMatrix(rhs.rows, rhs.columns, rhs.matrix, rhs.stride);
+
+        return Matrix(identifier, sparseKronecker(lhsEntries, rhsEntries));
+    }
+
+    Matrix result(identifier, rows * rhs.rows, columns * rhs.columns);
+    const KernelTable& kernel = kernels();
+
+    parallelFor(result.rows, result.rows * result.columns, [&](size_t begin, size_t end)
+    {
+        for (size_t row = begin; row < end; ++row)
+        {
+            const double* scales = matrix + (row / rhs.rows) * stride;
+            const double* copied = rhs.matrix + (row % rhs.rows) * rhs.stride;
+            double* out = result.matrix + row * result.stride;
+
+            for (size_t c = 0; c < columns; ++c) kernel.scale(out + c * rhs.columns, scales[c], copied, rhs.columns);
+        }
+    });
+
+    return result;
+}
+
+//Return this square matrix raised to the power |exponent|, named after this matrix
+//The squares of this matrix are walked by the bits of |exponent|, and the running product is multiplied by each square
+//whose bit is set. Every product is written into |scratch|, which then swaps buffers with the matrix it replaces, so
+//the three buffers are allocated once however large |exponent| is
+//The powers of a sparse matrix fill in quickly, they are computed dense
+Matrix Matrix::power(const size_t exponent) const
+{
+    Matrix result(identifier, rows, columns);
+
+    if (0 == exponent)
+    {
+        for (size_t i = 0; i < rows; ++i) result.at(i, i) = 1.0;
+        return result;
+    }
+
+    Matrix square(*this);
+    square.densify();
+    square.lu.reset();
+    square.qr.reset();
+
+    Matrix scratch(identifier, rows, columns);
+    const size_t bytes = rows * result.stride * sizeof(double);
+    bool first = true;
+
+    for (size_t bits = exponent; bits; bits >>= 1)
+    {
+        if (bits & 1)
+        {
+            //The first square taken is copied, multiplying it by the identity would only cost time
+            if (first) std::memcpy(result.matrix, square.matrix, bytes);
+
+            else
+            {
+                std::memset(scratch.matrix, 0, bytes);
+                result.multiply(square, scratch);
+                result.swapEntries(scratch);
+            }
+
+            first = false;
+        }
+
+        //No square is needed past the highest bit
+        if (bits > 1)
+        {
+            std::memset(scratch.matrix, 0, bytes);
+            square.multiply(square, scratch);
+            square.swapEntries(scratch);
+        }
+    }
+
+    return result;
+}
+
+//Exchange the dense entries of this matrix with those of |other|, both of the same order and |stride|
+//The buffers are swapped without copying
+void Matrix::swapEntries(Matrix& other)
+{
+    std::swap(matrix, other.matrix);
+
+    invalidateString();
+    other.invalidateString();
+}
+
+//Replace the dense |matrix| with |sparse| entries
+void Matrix::compress()
+{
+    sparse = new SparseMatrix(rows, columns, matrix, stride);
+
+    deallocate(matrix);
     matrix = nullptr;
+    stride = 0;
 }
 
 //True if the order of |other| matches to order of this matrix
@@ -9,9 +9,17 @@ sean.siders@icloud.com
 #include <iostream>
 #include <sstream>
 #include <fstream>
+#include <cstddef>
+#include <memory>
 
 //// FORWARD DECLARATION
 class Matrix;
+class SparseMatrix;
+class LuFactorization;
+class QrFactorization;
+
+template <typename E>
+class Expression;
 
 //// GLOBAL OPERATOR OVERLOADS
 std::ostream& operator<<(std::ostream& out, const Matrix& rhs);
@@ -30,24 +38,38 @@ class Matrix
     bool operator<(const std::string& rhs) const;
     bool operator>(const std::string& rhs) const;
     Matrix& operator=(const Matrix& rhs);
+    Matrix& operator=(Matrix&& rhs) noexcept;
+
+    //Evaluate an elementwise |expression| into this matrix, see |Expression.hpp|
+    template <typename E>
+    Matrix& operator=(const Expression<E>& expression);
 
     //// MATHEMATIC MATRIX OPERATORS
 
+    //Addition and subtraction (A + B, A - B) build fused expressions, see |Expression.hpp|
+
     //Addition
-    Matrix operator+(const Matrix& rhs) const;
     Matrix& operator+=(const Matrix& rhs);
 
     //Subtraction
-    Matrix operator-(const Matrix& rhs) const;
     Matrix& operator-=(const Matrix& rhs);
 
     //Multiplication
     Matrix operator*(const Matrix& rhs) const;
     Matrix& operator*=(const Matrix& rhs);
 
+    //Scaling, every entry is multiplied by |scalar|
+    Matrix& operator*=(const double scalar);
+
     Matrix();
     Matrix(const Matrix& source);
     Matrix(const Matrix& source, const std::string& identifier);
+    Matrix(Matrix&& source) noexcept;
+    Matrix(Matrix&& source, const std::string& identifier) noexcept;
+
+    //Evaluate an elementwise |expression| into a new matrix, see |Expression.hpp|
+    template <typename E>
+    Matrix(const Expression<E>& expression);
     Matrix(std::ifstream& inFile);
     ~Matrix();
 
@@ -55,6 +77,15 @@ class Matrix
     //Populate the |matrix| with the numeric entries in |matrixString|
     Matrix(const std::string& identifier, const std::string& matrixString, const size_t& rows, const size_t& columns);
 
+    //Allocate a zeroed |rows| x |columns| matrix, for the result of an operation
+    Matrix(const std::string& identifier, const size_t rows, const size_t columns);
+
+    //Take the sparse |entries| as the matrix, stored sparse or dense as |adaptStorage| decides
+    Matrix(const std::string& identifier, SparseMatrix&& entries);
+
+    //Copy the |rows| x |columns| row-major |buffer|, whose rows are |stride| entries apart
+    Matrix(const std::string& identifier, const double* buffer, const size_t rows, const size_t columns, const size_t stride);
+
     //Display the matrix |identifier| followed by the |matrixString|
     void display(std::ostream& out = std::cout) const;
 
@@ -65,6 +96,10 @@ class Matrix
     void overwrite(const Matrix& source);
     void overwrite(const Matrix& source, const std::string& newIdentifier);
 
+    //Clear the current matrix and take ownership of the buffer of |source|
+    void overwrite(Matrix&& source);
+    void overwrite(Matrix&& source, const std::string& newIdentifier);
+
     //Write the contents of of this matrix out to |outFile|
     void writeFile(std::ofstream& outFile) const;
 
@@ -79,6 +114,87 @@ class Matrix
     //Deallocate the |matrix|
     void clear();
 
+    //Store the matrix sparse if |sparseWorthwhile| holds for its nonzero entries, otherwise store it dense
+    //See |Sparse.hpp|
+    void adaptStorage();
+
+    //Store the matrix dense, for operations that only have a dense implementation
+    void densify();
+
+    //Return this matrix if it is dense, otherwise a dense copy of it expanded into |scratch|
+    //For reading the entries of an operand without changing how the operand is stored
+    const Matrix& dense(Matrix& scratch) const;
+
+    //Return the LU factorization of this square matrix, see |Lu.hpp|
+    //The factorization is cached, it is only computed again once the entries of the matrix change
+    const LuFactorization& factorization() const;
+
+    //Return X, the solution of this * X = |rhs|, named after |rhs|
+    //Every column of |rhs| is solved at once with the cached |factorization|
+    //This matrix must be square and not singular, and |rhs| must have as many rows as this matrix
+    Matrix solve(const Matrix& rhs) const;
+
+    //Return the inverse of this matrix, computed with the cached |factorization| in the buffer of the result
+    //This matrix must be square and not singular
+    Matrix inverse() const;
+
+    //Return the QR factorization of this matrix, see |Qr.hpp|
+    //The factorization is cached, it is only computed again once the entries of the matrix change
+    const QrFactorization& qrFactorization() const;
+
+    //Return the first min(|rows|, |columns|) columns of Q from the cached |qrFactorization|, named |name|
+    Matrix orthogonalFactor(const std::string& name) const;
+
+    //Return R from the cached |qrFactorization|, min(|rows|, |columns|) x |columns|, named |name|
+    Matrix triangularFactor(const std::string& name) const;
+
+    //Return X, the solution of this * X = |rhs| that minimizes the 2-norm of the residual, named after |rhs|
+    //This matrix must not be rank deficient, and |rhs| must have as many rows as this matrix
+    Matrix leastSquares(const Matrix& rhs) const;
+
+    //Return the largest sum of the absolute values of the entries in any column
+    double oneNorm() const;
+
+    //Return the transpose of this matrix, named after this matrix, see |Transpose.hpp|
+    Matrix transposed() const;
+
+    //Transpose this matrix, a dense square matrix is transposed within its own buffer
+    void transpose();
+
+    //Return op(this) * op(|rhs|), where op transposes its operand when |lhsTransposed| or |rhsTransposed| is set
+    //Large dense products read a transposed operand in place, the transpose is never formed
+    //The columns of op(this) must match the rows of op(|rhs|)
+    Matrix multiplyTransposed(const Matrix& rhs, const bool lhsTransposed, const bool rhsTransposed) const;
+
+    //Return the elementwise product of this matrix and |rhs|, or the elementwise quotient when |divide|
+    //Both matrices must be of the same order
+    Matrix hadamard(const Matrix& rhs, const bool divide) const;
+
+    //Return the Kronecker product of this matrix and |rhs|, in which each entry of this matrix scales a copy of |rhs|
+    Matrix kronecker(const Matrix& rhs) const;
+
+    //Return this square matrix raised to the power |exponent|, named after this matrix
+    //Binary exponentiation takes O(log |exponent|) products, written back and forth between buffers allocated once
+    Matrix power(const size_t exponent) const;
+
+    //////// GETTERS
+
+    size_t _rows() const { return rows; }
+
+    size_t _columns() const { return columns; }
+
+    //True if the matrix is stored sparse, see |Sparse.hpp|
+    bool _sparse() const { return sparse; }
+
+    //The name of this matrix
+    const std::string& _identifier() const { return identifier; }
+
+    //The row stride of |_buffer|
+    size_t _stride() const { return stride; }
+
+    //The row-major entries of this matrix, null while it is stored sparse
+    const double* _buffer() const { return matrix; }
+
     //Deallocate the |matrix| and set to null
     void clearMatrix();
 
@@ -88,7 +204,8 @@ class Matrix
     std::string identifier;
 
     //The string version of the matrix, for printing purposes
-    std::string matrixString;
+    //Formatted lazily by |text| and cached until the entries change
+    mutable std::string matrixString;
 
     //The number of rows in the matrix
     size_t rows;
@@ -96,8 +213,50 @@ class Matrix
     //The number of columns in the matrix
     size_t columns;
 
+    //The number of doubles between the first entries of consecutive rows in |matrix|
+    //Wide rows are padded so that every row begins on an |ALIGNMENT| byte boundary
+    size_t stride;
+
     //The matrix that contains all numeric values
-    double**  matrix;
+    //A single contiguous row-major buffer of |rows| x |stride| entries, aligned to |ALIGNMENT| bytes
+    double* matrix;
+
+    //The nonzero entries of the matrix when it is stored sparse, null while |matrix| holds the entries
+    //Exactly one of |matrix| and |sparse| is allocated for a non-empty matrix
+    SparseMatrix* sparse;
+
+    //False when |matrixString| no longer reflects the entries of |matrix|
+    mutable bool stringValid;
+
+    //The cached LU factorization of the entries, null until |factorization| is called or once the entries change
+    //Copies of a matrix share the same factorization
+    mutable std::shared_ptr<const LuFactorization> lu;
+
+    //The cached QR factorization of the entries, null until |qrFactorization| is called or once the entries change
+    mutable std::shared_ptr<const QrFactorization> qr;
+
+    //The byte alignment of |matrix| and of every padded row within it (one cache line)
+    static constexpr size_t ALIGNMENT = 64;
+
+    //Return the |stride| for a row of |columns| entries
+    //Rows narrower than one cache line are left unpadded
+    static size_t strideFor(const size_t columns);
+
+    //Allocate an aligned buffer of |rows| x |stride| entries, return null if the buffer would be empty
+    static double* allocate(const size_t rows, const size_t stride);
+
+    //Deallocate a |buffer| returned by |allocate|
+    static void deallocate(double* buffer);
+
+    //Access the entry at row |r| and column |c| of |matrix|
+    double& at(const size_t r, const size_t c) { return matrix[r * stride + c]; }
+    const double& at(const size_t r, const size_t c) const { return matrix[r * stride + c]; }
+
+    //Return the |matrixString|, formatting it from the entries of |matrix| only if it is stale
+    const std::string& text() const;
+
+    //Mark the |matrixString| as stale, it will be rebuilt by the next call to |text|
+    void invalidateString();
 
     //Allocate the |matrix| to the dimensions of |rows| x |columns|
     //Read in entries from the provided |stream|
@@ -106,13 +265,34 @@ class Matrix
     //Make a copy of |source| into this matrix
     void copy(const Matrix& source);
 
-    //Copy the |matrix| from |source|
+    //Copy the |matrix|, or the |sparse| entries, from |source|
     void copyMatrix(const Matrix& source);
 
-    //Multiply the current |matrix| with |other| as a |product| matrix
-    //Simultaneously deallocate |matrix| and modify |matrixString|
-    //Return the |product| matrix
-    double** multiply(const Matrix& rhs);
+    //Replace the dense |matrix| with |sparse| entries
+    void compress();
+
+    //Take the |matrix|, its order and the |matrixString| from |source|, leaving |source| empty
+    //The current |matrix| must already be deallocated
+    void take(Matrix&& source);
+
+    //Allocate |matrix| and write every entry of |expression| into it
+    template <typename E>
+    void evaluate(const E& expression);
+
+    //Add |rhs| to this matrix, or subtract it when |subtract|
+    void accumulate(const Matrix& rhs, const bool subtract);
+
+    //Multiply this matrix with |rhs|, writing the result into the zeroed dense |product|
+    //|product| must already be allocated to |rows| x |rhs.columns|
+    //At most one of this matrix and |rhs| may be sparse
+    void multiply(const Matrix& rhs, Matrix& product) const;
+
+    //Exchange the dense entries of this matrix with those of |other|, both of the same order and |stride|
+    //The buffers are swapped without copying
+    void swapEntries(Matrix& other);
 };
 
+//The elementwise expression templates are defined in terms of |Matrix|
+#include "Expression.hpp"
+
 #endif //MATRIX_HPP_
@@ -0,0 +1,155 @@
+/*
+A slab allocator for objects of a single type. Objects are carved out of slabs of contiguous slots, each slab a single
+allocation holding many objects, and destroyed objects return their slot to a free list for the next object to reuse.
+
+SLABS
+Slabs begin at |POOL_FIRST_SLAB| slots and double in size up to |POOL_LARGEST_SLAB|, so a pool of a few objects stays
+small while a pool of tens of thousands makes only a few allocations. |reserve| sizes the next slab to a known count,
+so a tree loaded from a file takes all of its nodes from one allocation.
+
+RELEASE
+|release| frees every slab at once without visiting the slots, the owner destroys the live objects first. Tearing down
+a pool of any size is then a few deallocations rather than one per object.
+
+@Sean Siders
+sean.siders@icloud.com
+*/
+
+#ifndef POOL_HPP_
+#define POOL_HPP_
+
+#include <algorithm>
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <vector>
+
+//The number of slots in the first slab of a pool
+const size_t POOL_FIRST_SLAB = 64;
+
+//Slabs double in size up to this many slots
+const size_t POOL_LARGEST_SLAB = 1 << 16;
+
+template <typename T>
+class ObjectPool
+{
+    public:
+    //////// CONSTRUCTORS
+
+    ObjectPool() : freeList(nullptr), cursor(nullptr), slabEnd(nullptr), nextSlab(POOL_FIRST_SLAB) {}
+
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool& operator=(const ObjectPool&) = delete;
+
+    //////// DESTRUCTOR
+
+    //Free every slab, the live objects must already be destroyed
+    ~ObjectPool()
+    {
+        release();
+    }
+
+    //////// PUBLIC FUNCTIONS
+
+    //Construct an object from |args| in a free slot, and return it
+    template <typename... Args>
+    T* create(Args&&... args)
+    {
+        Slot* slot = allocate();
+
+        try { return new (slot->storage) T(std::forward<Args>(args)...); }
+
+        catch (...)
+        {
+            deallocate(slot);
+            throw;
+        }
+    }
+
+    //Destroy |object| and return its slot to the free list
+    void destroy(T* object)
+    {
+        object->~T();
+        deallocate(reinterpret_cast<Slot*>(object));
+    }
+
+    //Make sure the next |count| objects are created with at most one more allocation
+    void reserve(const size_t count)
+    {
+        if (static_cast<size_t>(slabEnd - cursor) < count) grow(count);
+    }
+
+    //Free every slab at once, the live objects must already be destroyed
+    void release()
+    {
+        for (Slot* slab : slabs) delete[] slab;
+
+        slabs.clear();
+        freeList = nullptr;
+        cursor = nullptr;
+        slabEnd = nullptr;
+        nextSlab = POOL_FIRST_SLAB;
+    }
+
+    private:
+    //A slot holds an object while it is live, and the next free slot once it is destroyed
+    union Slot
+    {
+        Slot* next;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    //////// DATA
+
+    //Every slab allocated, each an array of slots
+    std::vector<Slot*> slabs;
+
+    //The most recently freed slot, each free slot points to the one freed before it
+    Slot* freeList;
+
+    //The next slot of the newest slab that has never been used, and the end of that slab
+    Slot* cursor;
+    Slot* slabEnd;
+
+    //The number of slots in the next slab
+    size_t nextSlab;
+
+    //////// PRIVATE FUNCTIONS
+
+    //Return a free slot, reusing a freed slot before taking a new one
+    Slot* allocate()
+    {
+        if (freeList)
+        {
+            Slot* slot = freeList;
+            freeList = slot->next;
+            return slot;
+        }
+
+        if (cursor == slabEnd) grow(nextSlab);
+
+        return cursor++;
+    }
+
+    void deallocate(Slot* slot)
+    {
+        slot->next = freeList;
+        freeList = slot;
+    }
+
+    //Start a new slab of |count| slots, the unused slots of the current slab join the free list
+    void grow(const size_t count)
+    {
+        slabs.reserve(slabs.size() + 1);
+        Slot* slab = new Slot[count];
+
+        while (cursor != slabEnd) deallocate(cursor++);
+
+        slabs.push_back(slab);
+        cursor = slab;
+        slabEnd = slab + count;
+        nextSlab = std::min(std::max(nextSlab, count) * 2, POOL_LARGEST_SLAB);
+    }
+};
+
+#endif //POOL_HPP_
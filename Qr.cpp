@@ -0,0 +1,341 @@
+/*
+@Sean Siders
+sean.siders@icloud.com
+*/
+
+#include "Qr.hpp"
+#include "Gemm.hpp"
+#include "Kernels.hpp"
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+//////// HELPERS
+
+//C += alpha * op(A) * B, where op(A) is |m| x |k| and transposes A when |transA|, B is |k| x |n| and C is |m| x |n|
+//Large products go through |gemm|, the rest stream through the rows of A and B without packing
+static void productInto(const bool transA, const size_t m, const size_t n, const size_t k, const double alpha,
+                        const double* A, const size_t lda, const double* B, const size_t ldb, double* C, const size_t ldc)
+{
+    if (gemmWorthwhile(m, n, k))
+    {
+        gemm(transA, false, m, n, k, alpha, A, lda, B, ldb, 1.0, C, ldc);
+        return;
+    }
+
+    //These products are thin, |m| or |n| is a handful of columns, so the loops are written out rather than calling a
+    //kernel for every few entries
+    if (transA)
+    {
+        //A and B are both walked one row at a time, each row of A scales row |p| of B into every row of C
+        for (size_t p = 0; p < k; ++p)
+        {
+            const double* a = A + p * lda;
+            const double* b = B + p * ldb;
+
+            for (size_t i = 0; i < m; ++i)
+            {
+                double* c = C + i * ldc;
+                const double scale = alpha * a[i];
+
+                for (size_t j = 0; j < n; ++j) c[j] += scale * b[j];
+            }
+        }
+
+        return;
+    }
+
+    //Every row of C is independent
+    parallelFor(m, m * n * k, [&](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; ++i)
+        {
+            double* c = C + i * ldc;
+
+            for (size_t p = 0; p < k; ++p)
+            {
+                const double* b = B + p * ldb;
+                const double scale = alpha * A[i * lda + p];
+
+                for (size_t j = 0; j < n; ++j) c[j] += scale * b[j];
+            }
+        }
+    });
+}
+
+//C += alpha * op(A) * B, as |productInto|
+//A product that reduces over more than |QR_CHUNK| rows of a transposed A is split into chunks of rows, each chunk is a
+//partial product computed on its own thread, and the partial products are summed in order of chunk
+static void multiplyAdd(const bool transA, const size_t m, const size_t n, const size_t k, const double alpha,
+                        const double* A, const size_t lda, const double* B, const size_t ldb, double* C, const size_t ldc)
+{
+    if (!m || !n || !k) return;
+
+    if (!transA || k <= QR_CHUNK)
+    {
+        productInto(transA, m, n, k, alpha, A, lda, B, ldb, C, ldc);
+        return;
+    }
+
+    const size_t chunks = (k + QR_CHUNK - 1) / QR_CHUNK;
+    std::vector<double> partial(chunks * m * n, 0.0);
+
+    parallelFor(chunks, m * n * k, [&](size_t begin, size_t end)
+    {
+        for (size_t chunk = begin; chunk < end; ++chunk)
+        {
+            const size_t p0 = chunk * QR_CHUNK;
+            const size_t depth = std::min(QR_CHUNK, k - p0);
+
+            productInto(true, m, n, depth, 1.0, A + p0 * lda, lda, B + p0 * ldb, ldb, &partial[chunk * m * n], n);
+        }
+    });
+
+    const KernelTable& kernel = kernels();
+
+    for (size_t chunk = 0; chunk < chunks; ++chunk)
+    {
+        for (size_t i = 0; i < m; ++i) kernel.axpy(C + i * ldc, alpha, &partial[(chunk * m + i) * n], n);
+    }
+}
+
+//////// CONSTRUCTORS
+
+//Factor the |rows| x |columns| row-major |buffer|, whose rows are |stride| entries apart
+//Each panel is factored, then its block reflector is applied to every column to the right of it
+QrFactorization::QrFactorization(const size_t rows, const size_t columns, const double* buffer, const size_t stride) :
+    rows(rows), columns(columns), reflectors(std::min(rows, columns)), factors(rows * columns),
+    triangles((reflectors + QR_BLOCK - 1) / QR_BLOCK * QR_BLOCK * QR_BLOCK, 0.0)
+{
+    for (size_t r = 0; r < rows; ++r) std::copy(buffer + r * stride, buffer + r * stride + columns, &factors[r * columns]);
+
+    for (size_t k0 = 0; k0 < reflectors; k0 += QR_BLOCK)
+    {
+        const size_t width = std::min(QR_BLOCK, reflectors - k0);
+        double* T = &triangles[k0 * QR_BLOCK];
+
+        factorPanel(k0, width, T);
+
+        if (k0 + width < columns)
+            applyBlock(k0, width, T, true, factors.data() + k0 + width, columns - k0 - width, columns);
+    }
+}
+
+//////// PUBLIC FUNCTIONS
+
+//True if the matrix is wider than it is tall, or a diagonal entry of R is no larger than max(|rows|, |columns|)
+//units of roundoff of the largest
+bool QrFactorization::rankDeficient() const
+{
+    if (rows < columns) return true;
+
+    double largest = 0.0;
+    for (size_t i = 0; i < reflectors; ++i) largest = std::max(largest, std::fabs(factors[i * columns + i]));
+
+    const double tolerance = rows * std::numeric_limits<double>::epsilon() * largest;
+
+    for (size_t i = 0; i < reflectors; ++i)
+        if (std::fabs(factors[i * columns + i]) <= tolerance) return true;
+
+    return false;
+}
+
+//Overwrite the |rows| x |count| row-major |B|, whose rows are |ldb| entries apart, with Q' * B
+//Q' = Pk' * ... * P1', so the block reflectors are applied first panel first
+void QrFactorization::applyQt(double* B, const size_t count, const size_t ldb) const
+{
+    for (size_t k0 = 0; k0 < reflectors; k0 += QR_BLOCK)
+        applyBlock(k0, std::min(QR_BLOCK, reflectors - k0), &triangles[k0 * QR_BLOCK], true, B, count, ldb);
+}
+
+//Overwrite the |rows| x |count| row-major |B|, whose rows are |ldb| entries apart, with Q * B
+//Q = P1 * ... * Pk, so the block reflectors are applied last panel first
+void QrFactorization::applyQ(double* B, const size_t count, const size_t ldb) const
+{
+    const size_t panels = (reflectors + QR_BLOCK - 1) / QR_BLOCK;
+
+    for (size_t panel = panels; panel-- > 0;)
+    {
+        const size_t k0 = panel * QR_BLOCK;
+        applyBlock(k0, std::min(QR_BLOCK, reflectors - k0), &triangles[k0 * QR_BLOCK], false, B, count, ldb);
+    }
+}
+
+//Write the first min(|rows|, |columns|) columns of Q into the zeroed |Q|, |rows| x min(|rows|, |columns|)
+//Q is applied to the first columns of the identity
+void QrFactorization::formQ(double* Q, const size_t ldq) const
+{
+    for (size_t i = 0; i < reflectors; ++i) Q[i * ldq + i] = 1.0;
+
+    applyQ(Q, reflectors, ldq);
+}
+
+//Write R into the zeroed |R|, min(|rows|, |columns|) x |columns|
+void QrFactorization::formR(double* R, const size_t ldr) const
+{
+    for (size_t i = 0; i < reflectors; ++i)
+        std::copy(&factors[i * columns + i], &factors[(i + 1) * columns], R + i * ldr + i);
+}
+
+//Overwrite the |rows| x |count| row-major |B| with Q' * B, then its first |columns| rows with the solution X
+//that minimizes the 2-norm of A * X - B
+//R * X = (Q' * B) restricted to its first |columns| rows, solved backward, the remaining rows hold the residual
+void QrFactorization::leastSquares(double* B, const size_t count, const size_t ldb) const
+{
+    const KernelTable& kernel = kernels();
+
+    applyQt(B, count, ldb);
+
+    for (size_t i = columns; i-- > 0;)
+    {
+        double* row = B + i * ldb;
+        const double* r = &factors[i * columns];
+
+        for (size_t j = i + 1; j < columns; ++j) kernel.axpy(row, -r[j], B + j * ldb, count);
+
+        const double inverse = 1.0 / r[i];
+        for (size_t c = 0; c < count; ++c) row[c] *= inverse;
+    }
+}
+
+//////// PRIVATE FUNCTIONS
+
+//Factor the |width| columns beginning at column and row |j0|, writing the T factor of their reflectors into |T|
+//A single column is one Householder reflector, wider panels are split in half:
+//  [V1 V2] has T = [T1, -T1 * (V1' * V2) * T2; 0, T2]
+void QrFactorization::factorPanel(const size_t j0, const size_t width, double* T)
+{
+    double* A = factors.data();
+
+    //The reflector that zeroes column |j0| below the diagonal, H = I - tau * v * v' with v(0) = 1
+    if (1 == width)
+    {
+        double tail = 0.0;
+        for (size_t i = j0 + 1; i < rows; ++i) tail += A[i * columns + j0] * A[i * columns + j0];
+
+        //The column is already zero below the diagonal, H is the identity
+        if (0.0 == tail)
+        {
+            T[0] = 0.0;
+            return;
+        }
+
+        const double alpha = A[j0 * columns + j0];
+        const double beta = -std::copysign(std::sqrt(alpha * alpha + tail), alpha);
+        const double scale = 1.0 / (alpha - beta);
+
+        for (size_t i = j0 + 1; i < rows; ++i) A[i * columns + j0] *= scale;
+
+        A[j0 * columns + j0] = beta;
+        T[0] = (beta - alpha) / beta;
+        return;
+    }
+
+    const size_t left = width / 2;
+    const size_t right = width - left;
+    const size_t j1 = j0 + left;
+    double* T2 = T + left * QR_BLOCK + left;
+
+    factorPanel(j0, left, T);
+    applyBlock(j0, left, T, true, A + j1, right, columns);
+    factorPanel(j1, right, T2);
+
+    //S = V1' * V2, the rows where V2 is unit lower triangular first, then the rows below the panel
+    std::vector<double> S(left * right, 0.0);
+
+    for (size_t q = 0; q < right; ++q)
+    {
+        const double* row = A + (j1 + q) * columns;
+
+        for (size_t i = 0; i < left; ++i)
+        {
+            for (size_t c = 0; c <= q; ++c) S[i * right + c] += row[j0 + i] * ((c == q) ? 1.0 : row[j1 + c]);
+        }
+    }
+
+    const size_t below = rows - j0 - width;
+    multiplyAdd(true, left, right, below, 1.0, A + (j0 + width) * columns + j0, columns,
+                A + (j0 + width) * columns + j1, columns, S.data(), right);
+
+    //T12 = -T1 * S * T2, both T factors are upper triangular
+    std::vector<double> product(left * right, 0.0);
+
+    for (size_t i = 0; i < left; ++i)
+    {
+        for (size_t l = i; l < left; ++l)
+            for (size_t c = 0; c < right; ++c) product[i * right + c] += T[i * QR_BLOCK + l] * S[l * right + c];
+    }
+
+    for (size_t i = 0; i < left; ++i)
+    {
+        for (size_t c = 0; c < right; ++c)
+        {
+            double sum = 0.0;
+            for (size_t l = 0; l <= c; ++l) sum += product[i * right + l] * T2[l * QR_BLOCK + c];
+
+            T[i * QR_BLOCK + left + c] = -sum;
+        }
+    }
+}
+
+//Apply the block reflector of the |width| columns beginning at |j0|, or its transpose when |transposed|, to the
+//|rows| x |count| row-major |B|, whose rows are |ldb| entries apart
+//B -= V * op(T) * (V' * B), where V is unit lower triangular in its first |width| rows
+void QrFactorization::applyBlock(const size_t j0, const size_t width, const double* T, const bool transposed,
+                                 double* B, const size_t count, const size_t ldb) const
+{
+    if (!count) return;
+
+    const KernelTable& kernel = kernels();
+    const double* A = factors.data();
+    const size_t below = rows - j0 - width;
+    const double* V = A + (j0 + width) * columns + j0;
+    double* bottom = B + (j0 + width) * ldb;
+
+    //W = V' * B, the triangle of V first, then the rows below it
+    std::vector<double> W(width * count, 0.0);
+
+    for (size_t r = 0; r < width; ++r)
+    {
+        const double* row = A + (j0 + r) * columns + j0;
+
+        for (size_t i = 0; i <= r; ++i) kernel.axpy(&W[i * count], (i == r) ? 1.0 : row[i], B + (j0 + r) * ldb, count);
+    }
+
+    multiplyAdd(true, width, count, below, 1.0, V, columns, bottom, ldb, W.data(), count);
+
+    //W = op(T) * W, in place, each row only reads rows that are yet to be overwritten
+    if (transposed)
+    {
+        for (size_t i = width; i-- > 0;)
+        {
+            double* row = &W[i * count];
+            for (size_t c = 0; c < count; ++c) row[c] *= T[i * QR_BLOCK + i];
+
+            for (size_t l = 0; l < i; ++l) kernel.axpy(row, T[l * QR_BLOCK + i], &W[l * count], count);
+        }
+    }
+
+    else
+    {
+        for (size_t i = 0; i < width; ++i)
+        {
+            double* row = &W[i * count];
+            for (size_t c = 0; c < count; ++c) row[c] *= T[i * QR_BLOCK + i];
+
+            for (size_t l = i + 1; l < width; ++l) kernel.axpy(row, T[i * QR_BLOCK + l], &W[l * count], count);
+        }
+    }
+
+    //B -= V * W, the rows below the triangle first, then the triangle
+    multiplyAdd(false, below, count, width, -1.0, V, columns, W.data(), count, bottom, ldb);
+
+    for (size_t r = 0; r < width; ++r)
+    {
+        const double* row = A + (j0 + r) * columns + j0;
+
+        for (size_t i = 0; i <= r; ++i)
+            kernel.axpy(B + (j0 + r) * ldb, (i == r) ? -1.0 : -row[i], &W[i * count], count);
+    }
+}
@@ -0,0 +1,107 @@
+/*
+Householder QR factorization, A = Q * R, for matrices of any shape. Q is orthogonal and R is upper triangular (upper
+trapezoidal when A is wide). Q is never stored as a matrix, it is kept as the product of min(rows, columns) Householder
+reflectors H = I - tau * v * v', whose vectors v are stored below the diagonal of R in a single buffer.
+
+COMPACT WY
+The reflectors of each panel of |QR_BLOCK| columns are combined into a single block reflector,
+H1 * H2 * ... * Hk = I - V * T * V', where V holds the vectors of the panel and T is a small upper triangular matrix.
+Applying a block reflector is two products with V and one with T, so updating the rest of the matrix, and applying Q or
+Q' to a block of right-hand sides, runs through |gemm| rather than as a sequence of rank-1 updates.
+
+RECURSIVE PANELS
+Each panel is itself factored recursively: the left half of the panel is factored, its block reflector is applied to the
+right half, the right half is factored, and the two T factors are joined. Even a tall and skinny matrix that is a single
+panel wide, such as the 1e6 x 50 design matrix of a regression, then does almost all of its work in matrix products.
+
+Products that reduce over the rows of a tall matrix (V' * C) are split into fixed chunks of |QR_CHUNK| rows across the
+thread pool, and the partial products are summed in order of chunk, so results are identical for any pool size.
+
+LEAST SQUARES
+For a matrix with at least as many rows as columns, |leastSquares| returns the X that minimizes the 2-norm of A * X - B,
+by applying Q' to B and solving the triangle R with the first rows of the result.
+
+|Matrix| caches its factorization until its entries change, see |Matrix::qrFactorization|.
+
+@Sean Siders
+sean.siders@icloud.com
+*/
+
+#ifndef QR_HPP_
+#define QR_HPP_
+
+#include <cstddef>
+#include <vector>
+
+//The number of columns in each panel of the blocked factorization, and the order of each T factor
+const size_t QR_BLOCK = 32;
+
+//The number of rows in each chunk of a reduction over the rows of a tall matrix
+const size_t QR_CHUNK = 16384;
+
+class QrFactorization
+{
+    public:
+    //////// CONSTRUCTORS
+
+    //Factor the |rows| x |columns| row-major |buffer|, whose rows are |stride| entries apart
+    QrFactorization(const size_t rows, const size_t columns, const double* buffer, const size_t stride);
+
+    //////// PUBLIC FUNCTIONS
+
+    //True if the matrix is wider than it is tall, or a diagonal entry of R is no larger than max(|rows|, |columns|)
+    //units of roundoff of the largest
+    bool rankDeficient() const;
+
+    //Overwrite the |rows| x |count| row-major |B|, whose rows are |ldb| entries apart, with Q' * B
+    void applyQt(double* B, const size_t count, const size_t ldb) const;
+
+    //Overwrite the |rows| x |count| row-major |B|, whose rows are |ldb| entries apart, with Q * B
+    void applyQ(double* B, const size_t count, const size_t ldb) const;
+
+    //Write the first min(|rows|, |columns|) columns of Q into the zeroed |Q|, |rows| x min(|rows|, |columns|)
+    void formQ(double* Q, const size_t ldq) const;
+
+    //Write R into the zeroed |R|, min(|rows|, |columns|) x |columns|
+    void formR(double* R, const size_t ldr) const;
+
+    //Overwrite the |rows| x |count| row-major |B| with Q' * B, then its first |columns| rows with the solution X
+    //that minimizes the 2-norm of A * X - B
+    //The factorization must not be |rankDeficient|
+    void leastSquares(double* B, const size_t count, const size_t ldb) const;
+
+    //////// GETTERS
+
+    size_t _rows() const { return rows; }
+
+    size_t _columns() const { return columns; }
+
+    //The number of Householder reflectors, min(|_rows|, |_columns|)
+    size_t _reflectors() const { return reflectors; }
+
+    private:
+    //The order of the factored matrix
+    size_t rows;
+    size_t columns;
+
+    //The number of Householder reflectors
+    size_t reflectors;
+
+    //R on and above the diagonal, the Householder vectors below it (their unit first entries are implied)
+    //Row-major with rows |columns| entries apart
+    std::vector<double> factors;
+
+    //The T factor of every panel, each |QR_BLOCK| x |QR_BLOCK| with only its upper triangle used
+    std::vector<double> triangles;
+
+    //Factor the |width| columns beginning at column and row |j0|, writing the T factor of their reflectors into |T|
+    void factorPanel(const size_t j0, const size_t width, double* T);
+
+    //Apply the block reflector of the |width| columns beginning at |j0|, or its transpose when |transposed|, to the
+    //|rows| x |count| row-major |B|, whose rows are |ldb| entries apart
+    //Only rows |j0| onward of B change
+    void applyBlock(const size_t j0, const size_t width, const double* T, const bool transposed,
+                    double* B, const size_t count, const size_t ldb) const;
+};
+
+#endif //QR_HPP_
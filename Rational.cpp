@@ -0,0 +1,310 @@
+/*
+@Sean Siders
+sean.siders@icloud.com
+*/
+
+#include "Rational.hpp"
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <string>
+
+//The estimated work of one fraction operation, counted in double multiply-adds
+const size_t RATIONAL_OPERATION_COST = 16;
+
+//////// CONSTRUCTORS
+
+//A |rows| x |columns| matrix of zeros
+RationalMatrix::RationalMatrix(const size_t rows, const size_t columns) :
+    rows(rows), columns(columns), entries(rows * columns) {}
+
+//Convert the |rows| x |columns| row-major |buffer|, whose rows are |stride| entries apart
+RationalMatrix::RationalMatrix(const size_t rows, const size_t columns, const double* buffer, const size_t stride) :
+    rows(rows), columns(columns), entries(rows * columns)
+{
+    for (size_t r = 0; r < rows; ++r)
+        for (size_t c = 0; c < columns; ++c) entries[r * columns + c] = Fraction::nearest(buffer[r * stride + c]);
+}
+
+//////// OPERATORS
+
+//Display the entries as reduced fractions, right aligned in columns
+std::ostream& operator<<(std::ostream& out, const RationalMatrix& rhs)
+{
+    std::vector<std::string> texts(rhs.entries.size());
+    std::vector<size_t> widths(rhs.columns, 0);
+
+    for (size_t r = 0; r < rhs.rows; ++r)
+    {
+        for (size_t c = 0; c < rhs.columns; ++c)
+        {
+            texts[r * rhs.columns + c] = rhs.at(r, c).text();
+            widths[c] = std::max(widths[c], texts[r * rhs.columns + c].size());
+        }
+    }
+
+    for (size_t r = 0; r < rhs.rows; ++r)
+    {
+        for (size_t c = 0; c < rhs.columns; ++c)
+        {
+            const std::string& text = texts[r * rhs.columns + c];
+            out << std::string(widths[c] - text.size() + (c ? 1 : 0), ' ') << text;
+        }
+
+        out << '\n';
+    }
+
+    return out;
+}
+
+//////// PUBLIC FUNCTIONS
+
+//Return the determinant, the matrix must be square
+//The determinant of the rows scaled to whole numbers, divided by the product of the scales
+Fraction RationalMatrix::determinant() const
+{
+    std::vector<Fraction> scaled = entries;
+    const Fraction scale = wholeRows(scaled, rows, columns);
+
+    Fraction result;
+    Fraction pivot;
+    eliminate(scaled, rows, columns, false, result, pivot);
+
+    return result / scale;
+}
+
+//Set |result| to the inverse, the matrix must be square
+//Elimination of [A | I] leaves [p * I | p * inv(A)], where p is the last pivot
+bool RationalMatrix::inverse(RationalMatrix& result) const
+{
+    RationalMatrix identity(rows, rows);
+    for (size_t i = 0; i < rows; ++i) identity.at(i, i) = Fraction(1);
+
+    return solve(identity, result);
+}
+
+//Set |result| to the solution X of A * X = |rhs|
+//Elimination of [A | B] leaves [p * I | p * X], where p is the last pivot, scaling a row of [A | B] does not change X
+//p is the determinant only up to sign, the sign of the row swaps is not carried by the rows themselves
+bool RationalMatrix::solve(const RationalMatrix& rhs, RationalMatrix& result) const
+{
+    const size_t width = columns + rhs.columns;
+    std::vector<Fraction> augmented(rows * width);
+
+    for (size_t r = 0; r < rows; ++r)
+    {
+        const Fraction* lhsRow = &entries[r * columns];
+        const Fraction* rhsRow = &rhs.entries[r * rhs.columns];
+
+        std::copy(lhsRow, lhsRow + columns, &augmented[r * width]);
+        std::copy(rhsRow, rhsRow + rhs.columns, &augmented[r * width + columns]);
+    }
+
+    wholeRows(augmented, rows, width);
+
+    Fraction determinant;
+    Fraction pivot;
+    if (!eliminate(augmented, rows, width, true, determinant, pivot)) return false;
+
+    result = RationalMatrix(rows, rhs.columns);
+
+    parallelFor(rows, rows * rhs.columns * RATIONAL_OPERATION_COST, [&](size_t begin, size_t end)
+    {
+        for (size_t r = begin; r < end; ++r)
+        {
+            for (size_t c = 0; c < rhs.columns; ++c)
+                result.entries[r * rhs.columns + c] = augmented[r * width + columns + c] / pivot;
+        }
+    });
+
+    return true;
+}
+
+//Solve and invert fixed matrices whose columns need row swaps to find a pivot, and compare the results with their
+//known exact values
+//Return the names of the cases that failed
+std::vector<std::string> RationalMatrix::check()
+{
+    std::vector<std::string> failed;
+
+    //A zero leading pivot, one row swap
+    const double swapOnce[] = {0, 2,
+                               3, 0};
+
+    //Zero leading pivots in the first two columns, two row swaps
+    const double swapTwice[] = {0, 0, 2,
+                                1, 0, 0,
+                                0, 3, 0};
+
+    //A zero leading pivot, one row swap, and entries that do not divide evenly
+    const double swapDense[] = {0, 1, 2,
+                                0, 3, 1,
+                                4, 1, 1};
+
+    //solve [0 2; 3 0] [4; 9] is exactly [3; 2]
+    const double rhsOnce[] = {4, 9};
+    RationalMatrix solution(0, 0);
+
+    if (!RationalMatrix(2, 2, swapOnce, 2).solve(RationalMatrix(2, 1, rhsOnce, 1), solution) ||
+        Fraction(3) != solution.at(0, 0) || Fraction(2) != solution.at(1, 0))
+    {
+        failed.push_back("solve, one row swap");
+    }
+
+    //A * inv(A) is exactly the identity
+    const auto invertible = [&failed](const std::string& name, const size_t order, const double* buffer)
+    {
+        const RationalMatrix matrix(order, order, buffer, order);
+        RationalMatrix inverse(0, 0);
+
+        if (!matrix.inverse(inverse))
+        {
+            failed.push_back(name);
+            return;
+        }
+
+        for (size_t r = 0; r < order; ++r)
+        {
+            for (size_t c = 0; c < order; ++c)
+            {
+                Fraction entry;
+                for (size_t k = 0; k < order; ++k) entry += matrix.at(r, k) * inverse.at(k, c);
+
+                if (Fraction(r == c ? 1 : 0) != entry)
+                {
+                    failed.push_back(name);
+                    return;
+                }
+            }
+        }
+    };
+
+    invertible("inv, one row swap", 2, swapOnce);
+    invertible("inv, two row swaps", 3, swapTwice);
+    invertible("inv, one row swap of a dense matrix", 3, swapDense);
+
+    //The determinant keeps the sign of the swaps
+    if (Fraction(-20) != RationalMatrix(3, 3, swapDense, 3).determinant()) failed.push_back("det, one row swap");
+
+    return failed;
+}
+
+//Return the entries rounded to doubles, row-major with rows |_columns| entries apart
+std::vector<double> RationalMatrix::toDoubles() const
+{
+    std::vector<double> result(entries.size());
+    for (size_t i = 0; i < entries.size(); ++i) result[i] = entries[i].toDouble();
+
+    return result;
+}
+
+//Return the number of entries that outgrew 64 bits
+size_t RationalMatrix::bigEntries() const
+{
+    return std::count_if(entries.begin(), entries.end(), [](const Fraction& entry) { return entry._big(); });
+}
+
+//////// PRIVATE FUNCTIONS
+
+//Multiply each row of the |count| x |width| row-major |augmented| by the least common multiple of its denominators,
+//so every entry becomes a whole number
+//Return the product of the multipliers
+Fraction RationalMatrix::wholeRows(std::vector<Fraction>& augmented, const size_t count, const size_t width)
+{
+    const Int one(1);
+    Fraction product(1);
+
+    for (size_t r = 0; r < count; ++r)
+    {
+        Fraction* row = &augmented[r * width];
+        Int multiple(1);
+        Int quotient;
+        Int remainder;
+
+        for (size_t c = 0; c < width; ++c)
+        {
+            const Int denominator = row[c].bigDenominator();
+            if (one == denominator) continue;
+
+            Int::divide(denominator, Int::gcd(multiple, denominator), quotient, remainder);
+            multiple = multiple * quotient;
+        }
+
+        if (one == multiple) continue;
+
+        for (size_t c = 0; c < width; ++c)
+        {
+            Int::divide(multiple, row[c].bigDenominator(), quotient, remainder);
+            row[c] = Fraction(row[c].bigNumerator() * quotient, one);
+        }
+
+        product = product * Fraction(multiple, one);
+    }
+
+    return product;
+}
+
+//Eliminate the whole numbers of the |order| x |width| row-major |augmented| by Bareiss' fraction-free elimination, and
+//set |determinant| to the determinant of its first |order| columns and |pivot| to the last pivot
+//Step k replaces every other entry a(i, j) with (a(k, k) * a(i, j) - a(i, k) * a(k, j)) / p, where p is the pivot of
+//the step before. The division is always exact, so every entry stays a whole number, the determinant of a submatrix,
+//and no gcd is ever taken
+bool RationalMatrix::eliminate(std::vector<Fraction>& augmented, const size_t order, const size_t width, const bool full,
+                               Fraction& determinant, Fraction& pivot)
+{
+    Fraction previous(1);
+    bool negate = false;
+
+    for (size_t k = 0; k < order; ++k)
+    {
+        size_t nonzero = k;
+        while (nonzero < order && augmented[nonzero * width + k]._zero()) ++nonzero;
+
+        if (order == nonzero)
+        {
+            determinant = Fraction();
+            pivot = Fraction();
+            return false;
+        }
+
+        if (nonzero != k)
+        {
+            std::swap_ranges(&augmented[nonzero * width], &augmented[nonzero * width] + width, &augmented[k * width]);
+            negate = !negate;
+        }
+
+        const Fraction* pivotRow = &augmented[k * width];
+        const Fraction& diagonal = pivotRow[k];
+
+        //Rows above the pivot are only eliminated in full, the rows below always
+        const size_t first = full ? 0 : k + 1;
+
+        parallelFor(order - first, (order - first) * width * RATIONAL_OPERATION_COST, [&](size_t begin, size_t end)
+        {
+            for (size_t i = first + begin; i < first + end; ++i)
+            {
+                if (k == i) continue;
+
+                Fraction* row = &augmented[i * width];
+                const Fraction multiplier = row[k];
+
+                for (size_t j = full ? 0 : k + 1; j < width; ++j)
+                {
+                    if (k == j) continue;
+
+                    Fraction entry = diagonal * row[j];
+                    if (!multiplier._zero() && !pivotRow[j]._zero()) entry -= multiplier * pivotRow[j];
+
+                    row[j] = entry / previous;
+                }
+
+                row[k] = Fraction();
+            }
+        });
+
+        previous = diagonal;
+    }
+
+    pivot = previous;
+    determinant = negate ? -previous : previous;
+    return true;
+}
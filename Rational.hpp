@@ -0,0 +1,105 @@
+/*
+Exact rational matrices, for results that must not carry roundoff such as the determinant or inverse of a matrix of
+audited figures. Every entry is a |Fraction| (see |Value.hpp|), so entries of small numerators and denominators stay on
+its 64 bit fast path, and only entries that outgrow 64 bits pay for arbitrary precision.
+
+CONVERSION
+Matrices are stored as doubles, so each entry is converted to the fraction with the smallest denominator that rounds to
+it. An entry entered as 0.1 becomes exactly 1/10, not the binary fraction the double holds.
+
+ELIMINATION
+Determinants, inverses and solutions use Bareiss' fraction-free elimination. Each row is first scaled to whole numbers,
+then every step divides exactly by the pivot of the step before, so the entries remain whole numbers no larger than the
+determinants of submatrices. Eliminating with fractions instead would take a gcd in every operation, on numerators and
+denominators just as large. A solve only divides by the last pivot at the very end, once per entry of the solution. The
+last pivot is the determinant up to the sign of the row swaps.
+
+Exact arithmetic has no roundoff to control, so the pivot of each column is its first nonzero entry rather than its
+largest. The rows of each step are updated across the thread pool, every row by a single thread, so results are
+identical for any pool size.
+
+@Sean Siders
+sean.siders@icloud.com
+*/
+
+#ifndef RATIONAL_HPP_
+#define RATIONAL_HPP_
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "Value.hpp"
+
+class RationalMatrix
+{
+    public:
+    //////// CONSTRUCTORS
+
+    //A |rows| x |columns| matrix of zeros
+    RationalMatrix(const size_t rows, const size_t columns);
+
+    //Convert the |rows| x |columns| row-major |buffer|, whose rows are |stride| entries apart
+    //Each entry becomes the fraction with the smallest denominator that rounds to it, every entry must be finite
+    RationalMatrix(const size_t rows, const size_t columns, const double* buffer, const size_t stride);
+
+    //////// OPERATORS
+
+    //Display the entries as reduced fractions, right aligned in columns
+    friend std::ostream& operator<<(std::ostream& out, const RationalMatrix& rhs);
+
+    //////// PUBLIC FUNCTIONS
+
+    //Return the determinant, the matrix must be square
+    Fraction determinant() const;
+
+    //Set |result| to the inverse, the matrix must be square
+    //Return false if the matrix is singular
+    bool inverse(RationalMatrix& result) const;
+
+    //Set |result| to the solution X of A * X = |rhs|, the matrix must be square with as many rows as |rhs|
+    //Return false if the matrix is singular
+    bool solve(const RationalMatrix& rhs, RationalMatrix& result) const;
+
+    //Solve and invert fixed matrices whose columns need row swaps to find a pivot, and compare the results with their
+    //known exact values
+    //Return the names of the cases that failed
+    static std::vector<std::string> check();
+
+    //Return the entries rounded to doubles, row-major with rows |_columns| entries apart
+    std::vector<double> toDoubles() const;
+
+    //Return the number of entries that outgrew 64 bits
+    size_t bigEntries() const;
+
+    Fraction& at(const size_t r, const size_t c) { return entries[r * columns + c]; }
+
+    const Fraction& at(const size_t r, const size_t c) const { return entries[r * columns + c]; }
+
+    //////// GETTERS
+
+    size_t _rows() const { return rows; }
+
+    size_t _columns() const { return columns; }
+
+    private:
+    size_t rows;
+    size_t columns;
+
+    //Row-major with rows |columns| entries apart
+    std::vector<Fraction> entries;
+
+    //Multiply each row of the |count| x |width| row-major |augmented| by the least common multiple of its
+    //denominators, so every entry becomes a whole number
+    //Return the product of the multipliers
+    static Fraction wholeRows(std::vector<Fraction>& augmented, const size_t count, const size_t width);
+
+    //Eliminate the whole numbers of the |order| x |width| row-major |augmented| so that its first |order| columns are
+    //p times the identity, or upper triangular when not |full|, where p is the last pivot
+    //Set |pivot| to p and |determinant| to the determinant of the first |order| columns, which is -p after an odd
+    //number of row swaps, or set both to zero and return false if the first |order| columns are singular
+    static bool eliminate(std::vector<Fraction>& augmented, const size_t order, const size_t width, const bool full,
+                          Fraction& determinant, Fraction& pivot);
+};
+
+#endif //RATIONAL_HPP_
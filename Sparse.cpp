@@ -0,0 +1,397 @@
+/*
+@Sean Siders
+sean.siders@icloud.com
+*/
+
+#include "Sparse.hpp"
+#include "Kernels.hpp"
+#include "ThreadPool.hpp"
+#include <algorithm>
+
+//////// CONSTRUCTORS
+
+SparseMatrix::SparseMatrix() : rows(0), columns(0), rowStart(1, 0) {}
+
+//A |rows| x |columns| matrix with no nonzero entries
+SparseMatrix::SparseMatrix(const size_t rows, const size_t columns) : rows(rows), columns(columns), rowStart(1, 0)
+{
+    rowStart.reserve(rows + 1);
+}
+
+//Compress the |rows| x |columns| row-major |buffer|, whose rows are |stride| entries apart
+SparseMatrix::SparseMatrix(const size_t rows, const size_t columns, const double* buffer, const size_t stride) :
+    rows(rows), columns(columns), rowStart(1, 0)
+{
+    const size_t nonzeros = countNonzeros(rows, columns, buffer, stride);
+
+    rowStart.reserve(rows + 1);
+    columnIndex.reserve(nonzeros);
+    values.reserve(nonzeros);
+
+    for (size_t r = 0; r < rows; ++r)
+    {
+        const double* row = buffer + r * stride;
+
+        for (size_t c = 0; c < columns; ++c) append(c, row[c]);
+
+        endRow();
+    }
+}
+
+//////// PUBLIC FUNCTIONS
+
+//Append an entry to the row being built, columns must be appended in ascending order
+//Zero entries are skipped
+void SparseMatrix::append(const size_t column, const double value)
+{
+    if (0.0 == value) return;
+
+    columnIndex.push_back(column);
+    values.push_back(value);
+}
+
+//Finish the row being built and begin the next one
+void SparseMatrix::endRow()
+{
+    rowStart.push_back(values.size());
+}
+
+//Return the entry at row |r| and column |c|
+//The columns of a row are ascending, so the entry is found by binary search
+double SparseMatrix::entry(const size_t r, const size_t c) const
+{
+    const size_t* begin = columnIndex.data() + rowStart[r];
+    const size_t* end = columnIndex.data() + rowStart[r + 1];
+    const size_t* found = std::lower_bound(begin, end, c);
+
+    return (found != end && c == *found) ? values[found - columnIndex.data()] : 0.0;
+}
+
+//Write every entry into the zeroed row-major |buffer|, whose rows are |stride| entries apart
+void SparseMatrix::expand(double* buffer, const size_t stride) const
+{
+    for (size_t r = 0; r < rows; ++r)
+    {
+        for (size_t i = rowStart[r]; i < rowStart[r + 1]; ++i) buffer[r * stride + columnIndex[i]] = values[i];
+    }
+}
+
+//Add every entry to the row-major |buffer|, or subtract it when |subtract|
+void SparseMatrix::scatter(double* buffer, const size_t stride, const bool subtract) const
+{
+    for (size_t r = 0; r < rows; ++r)
+    {
+        double* row = buffer + r * stride;
+
+        for (size_t i = rowStart[r]; i < rowStart[r + 1]; ++i)
+        {
+            if (subtract) row[columnIndex[i]] -= values[i];
+            else row[columnIndex[i]] += values[i];
+        }
+    }
+}
+
+//Multiply every entry by |factor|, a zero |factor| leaves no nonzero entries
+void SparseMatrix::scale(const double factor)
+{
+    if (0.0 == factor)
+    {
+        std::fill(rowStart.begin(), rowStart.end(), 0);
+        columnIndex.clear();
+        values.clear();
+        return;
+    }
+
+    kernels().scale(values.data(), factor, values.data(), values.size());
+}
+
+//////// FUNCTIONS
+
+//True if a |rows| x |columns| matrix with |nonzeros| nonzero entries should be stored sparse
+bool sparseWorthwhile(const size_t rows, const size_t columns, const size_t nonzeros)
+{
+    const size_t entries = rows * columns;
+
+    return entries >= SPARSE_MIN_ENTRIES && nonzeros <= SPARSE_DENSITY * entries;
+}
+
+//Return the number of nonzero entries in the |rows| x |columns| row-major |buffer|
+size_t countNonzeros(const size_t rows, const size_t columns, const double* buffer, const size_t stride)
+{
+    size_t nonzeros = 0;
+
+    for (size_t r = 0; r < rows; ++r)
+    {
+        const double* row = buffer + r * stride;
+
+        for (size_t c = 0; c < columns; ++c) nonzeros += (0.0 != row[c]);
+    }
+
+    return nonzeros;
+}
+
+//Return |lhs| + |rhs|, or |lhs| - |rhs| when |subtract|, both must be of the same order
+//Each pair of rows is merged in order of column, entries that cancel out are dropped
+SparseMatrix sparseSum(const SparseMatrix& lhs, const SparseMatrix& rhs, const bool subtract)
+{
+    SparseMatrix sum(lhs._rows(), lhs._columns());
+
+    const size_t* lhsColumn = lhs._columnIndex();
+    const size_t* rhsColumn = rhs._columnIndex();
+    const double* lhsValue = lhs._values();
+    const double* rhsValue = rhs._values();
+    const double sign = subtract ? -1.0 : 1.0;
+
+    for (size_t r = 0; r < lhs._rows(); ++r)
+    {
+        size_t i = lhs._rowBegin(r);
+        size_t j = rhs._rowBegin(r);
+        const size_t lhsEnd = lhs._rowEnd(r);
+        const size_t rhsEnd = rhs._rowEnd(r);
+
+        while (i < lhsEnd || j < rhsEnd)
+        {
+            //Only |lhs| has an entry in this column
+            if (j == rhsEnd || (i < lhsEnd && lhsColumn[i] < rhsColumn[j]))
+            {
+                sum.append(lhsColumn[i], lhsValue[i]);
+                ++i;
+            }
+
+            //Only |rhs| has an entry in this column
+            else if (i == lhsEnd || rhsColumn[j] < lhsColumn[i])
+            {
+                sum.append(rhsColumn[j], sign * rhsValue[j]);
+                ++j;
+            }
+
+            //Both have an entry in this column
+            else
+            {
+                sum.append(lhsColumn[i], subtract ? lhsValue[i] - rhsValue[j] : lhsValue[i] + rhsValue[j]);
+                ++i;
+                ++j;
+            }
+        }
+
+        sum.endRow();
+    }
+
+    return sum;
+}
+
+//C = A * B for a sparse A and a dense B of |columns| columns, C must be zeroed
+//Every nonzero A(r, k) adds a scaled row k of B to row r of C, each row of C is built independently
+void sparseDense(const SparseMatrix& A, const double* B, const size_t ldb, const size_t columns,
+                 double* C, const size_t ldc)
+{
+    const KernelTable& kernel = kernels();
+    const size_t* column = A._columnIndex();
+    const double* value = A._values();
+
+    parallelFor(A._rows(), A._nonzeros() * columns, [&](size_t begin, size_t end)
+    {
+        for (size_t r = begin; r < end; ++r)
+        {
+            for (size_t i = A._rowBegin(r); i < A._rowEnd(r); ++i)
+                kernel.axpy(C + r * ldc, value[i], B + column[i] * ldb, columns);
+        }
+    });
+}
+
+//C = A * B for a dense A of |rows| rows and a sparse B, C must be zeroed
+//Every nonzero A(r, k) scatters a scaled row k of B into row r of C
+void denseSparse(const size_t rows, const double* A, const size_t lda, const SparseMatrix& B,
+                 double* C, const size_t ldc)
+{
+    const size_t* column = B._columnIndex();
+    const double* value = B._values();
+
+    parallelFor(rows, rows * (B._rows() + B._nonzeros()), [&](size_t begin, size_t end)
+    {
+        for (size_t r = begin; r < end; ++r)
+        {
+            double* productRow = C + r * ldc;
+
+            for (size_t k = 0; k < B._rows(); ++k)
+            {
+                const double a = A[r * lda + k];
+                if (0.0 == a) continue;
+
+                for (size_t i = B._rowBegin(k); i < B._rowEnd(k); ++i) productRow[column[i]] += a * value[i];
+            }
+        }
+    });
+}
+
+//Return A * B for a sparse A and a sparse B
+//Each row of the product is accumulated in a dense row of scratch (Gustavson's algorithm), only the columns it touches
+//are visited, so the cost scales with the multiply-adds performed rather than with the order of the product
+SparseMatrix sparseSparse(const SparseMatrix& A, const SparseMatrix& B)
+{
+    SparseMatrix product(A._rows(), B._columns());
+
+    const size_t* aColumn = A._columnIndex();
+    const double* aValue = A._values();
+    const size_t* bColumn = B._columnIndex();
+    const double* bValue = B._values();
+
+    //The running sum of each column of the current row, and whether that column was touched
+    std::vector<double> accumulator(B._columns(), 0.0);
+    std::vector<bool> touched(B._columns(), false);
+
+    //The columns touched by the current row
+    std::vector<size_t> pattern;
+
+    for (size_t r = 0; r < A._rows(); ++r)
+    {
+        for (size_t i = A._rowBegin(r); i < A._rowEnd(r); ++i)
+        {
+            const size_t k = aColumn[i];
+
+            for (size_t j = B._rowBegin(k); j < B._rowEnd(k); ++j)
+            {
+                const size_t c = bColumn[j];
+
+                if (!touched[c])
+                {
+                    touched[c] = true;
+                    pattern.push_back(c);
+                }
+
+                accumulator[c] += aValue[i] * bValue[j];
+            }
+        }
+
+        //Emit the row in order of column and reset the scratch it used
+        std::sort(pattern.begin(), pattern.end());
+
+        for (const size_t c : pattern)
+        {
+            product.append(c, accumulator[c]);
+            accumulator[c] = 0.0;
+            touched[c] = false;
+        }
+
+        pattern.clear();
+        product.endRow();
+    }
+
+    return product;
+}
+
+//Return the transpose of A
+//The entries are bucketed by column with a counting sort, rows of A are visited in order so every row of the transpose
+//comes out with its columns ascending, the cost scales with the number of nonzeros
+SparseMatrix sparseTranspose(const SparseMatrix& A)
+{
+    const size_t* column = A._columnIndex();
+    const double* value = A._values();
+
+    //The offset of each row of the transpose, counted from the columns of A
+    std::vector<size_t> start(A._columns() + 1, 0);
+    for (size_t i = 0; i < A._nonzeros(); ++i) ++start[column[i] + 1];
+    for (size_t c = 0; c < A._columns(); ++c) start[c + 1] += start[c];
+
+    std::vector<size_t> rowOf(A._nonzeros());
+    std::vector<double> valueOf(A._nonzeros());
+    std::vector<size_t> next(start.begin(), start.end() - 1);
+
+    for (size_t r = 0; r < A._rows(); ++r)
+    {
+        for (size_t i = A._rowBegin(r); i < A._rowEnd(r); ++i)
+        {
+            const size_t slot = next[column[i]]++;
+            rowOf[slot] = r;
+            valueOf[slot] = value[i];
+        }
+    }
+
+    SparseMatrix transpose(A._columns(), A._rows());
+
+    for (size_t c = 0; c < A._columns(); ++c)
+    {
+        for (size_t i = start[c]; i < start[c + 1]; ++i) transpose.append(rowOf[i], valueOf[i]);
+
+        transpose.endRow();
+    }
+
+    return transpose;
+}
+
+//Return the elementwise product of A and the row-major B, whose rows are |ldb| entries apart
+//Only the nonzero entries of A can give a nonzero product
+SparseMatrix sparseHadamard(const SparseMatrix& A, const double* B, const size_t ldb)
+{
+    const size_t* column = A._columnIndex();
+    const double* value = A._values();
+    SparseMatrix product(A._rows(), A._columns());
+
+    for (size_t r = 0; r < A._rows(); ++r)
+    {
+        for (size_t i = A._rowBegin(r); i < A._rowEnd(r); ++i) product.append(column[i], value[i] * B[r * ldb + column[i]]);
+
+        product.endRow();
+    }
+
+    return product;
+}
+
+//Return the elementwise product of A and B
+//The ascending columns of each row of A and B are merged, only columns found in both give a product
+SparseMatrix sparseHadamard(const SparseMatrix& A, const SparseMatrix& B)
+{
+    const size_t* columnA = A._columnIndex();
+    const size_t* columnB = B._columnIndex();
+    SparseMatrix product(A._rows(), A._columns());
+
+    for (size_t r = 0; r < A._rows(); ++r)
+    {
+        size_t i = A._rowBegin(r);
+        size_t j = B._rowBegin(r);
+
+        while (i < A._rowEnd(r) && j < B._rowEnd(r))
+        {
+            if (columnA[i] < columnB[j]) ++i;
+            else if (columnB[j] < columnA[i]) ++j;
+            else
+            {
+                product.append(columnA[i], A._values()[i] * B._values()[j]);
+                ++i;
+                ++j;
+            }
+        }
+
+        product.endRow();
+    }
+
+    return product;
+}
+
+//Return the Kronecker product of A and B, each entry of A scales a copy of B
+//Row i * |B._rows()| + r of the product is row r of B scaled by each nonzero entry of row i of A in turn, so the
+//columns of every row are appended in ascending order
+SparseMatrix sparseKronecker(const SparseMatrix& A, const SparseMatrix& B)
+{
+    const size_t* columnA = A._columnIndex();
+    const size_t* columnB = B._columnIndex();
+    SparseMatrix product(A._rows() * B._rows(), A._columns() * B._columns());
+
+    for (size_t i = 0; i < A._rows(); ++i)
+    {
+        for (size_t r = 0; r < B._rows(); ++r)
+        {
+            for (size_t a = A._rowBegin(i); a < A._rowEnd(i); ++a)
+            {
+                const size_t offset = columnA[a] * B._columns();
+
+                for (size_t b = B._rowBegin(r); b < B._rowEnd(r); ++b)
+                    product.append(offset + columnB[b], A._values()[a] * B._values()[b]);
+            }
+
+            product.endRow();
+        }
+    }
+
+    return product;
+}
@@ -0,0 +1,133 @@
+/*
+Compressed sparse row (CSR) storage for matrices that are mostly zeros. Only the nonzero entries are stored, row by row:
+
+- |rowStart| : where each row begins in |columnIndex| and |values|, with one extra entry marking the end of the last row
+- |columnIndex| : the column of each nonzero entry, ascending within a row
+- |values| : the nonzero entries themselves
+
+Memory and the cost of every kernel below scale with the number of nonzeros, not with the order of the matrix. The
+product of a dense matrix with a sparse matrix walks the sparse rows as well, so no column (CSC) copy is ever needed.
+
+WHEN A MATRIX IS STORED SPARSE
+|Matrix| switches to this storage when |sparseWorthwhile| holds, that is when the matrix has at least
+|SPARSE_MIN_ENTRIES| entries and no more than |SPARSE_DENSITY| of them are nonzero.
+
+@Sean Siders
+sean.siders@icloud.com
+*/
+
+#ifndef SPARSE_HPP_
+#define SPARSE_HPP_
+
+#include <cstddef>
+#include <vector>
+
+//The largest fraction of nonzero entries a matrix may have and still be stored sparse
+const double SPARSE_DENSITY = 0.05;
+
+//Matrices with fewer entries than this are always stored dense, the dense kernels are faster at that size
+const size_t SPARSE_MIN_ENTRIES = 1024;
+
+class SparseMatrix
+{
+    public:
+    //////// CONSTRUCTORS
+
+    SparseMatrix();
+
+    //A |rows| x |columns| matrix with no nonzero entries
+    SparseMatrix(const size_t rows, const size_t columns);
+
+    //Compress the |rows| x |columns| row-major |buffer|, whose rows are |stride| entries apart
+    SparseMatrix(const size_t rows, const size_t columns, const double* buffer, const size_t stride);
+
+    //////// PUBLIC FUNCTIONS
+
+    //Append an entry to the row being built, columns must be appended in ascending order
+    //Zero entries are skipped
+    void append(const size_t column, const double value);
+
+    //Finish the row being built and begin the next one
+    void endRow();
+
+    //Return the entry at row |r| and column |c|
+    double entry(const size_t r, const size_t c) const;
+
+    //Write every entry into the zeroed row-major |buffer|, whose rows are |stride| entries apart
+    void expand(double* buffer, const size_t stride) const;
+
+    //Add every entry to the row-major |buffer|, or subtract it when |subtract|
+    void scatter(double* buffer, const size_t stride, const bool subtract) const;
+
+    //Multiply every entry by |factor|, a zero |factor| leaves no nonzero entries
+    void scale(const double factor);
+
+    //////// GETTERS
+
+    size_t _rows() const { return rows; }
+
+    size_t _columns() const { return columns; }
+
+    size_t _nonzeros() const { return values.size(); }
+
+    //The nonzero entries of row |r| are [|_rowBegin(r)|, |_rowEnd(r)|) of |_columnIndex| and |_values|
+    size_t _rowBegin(const size_t r) const { return rowStart[r]; }
+
+    size_t _rowEnd(const size_t r) const { return rowStart[r + 1]; }
+
+    const size_t* _columnIndex() const { return columnIndex.data(); }
+
+    const double* _values() const { return values.data(); }
+
+    private:
+    //The number of rows in the matrix
+    size_t rows;
+
+    //The number of columns in the matrix
+    size_t columns;
+
+    //The offset of the first nonzero entry of each row, followed by the number of nonzero entries
+    std::vector<size_t> rowStart;
+
+    //The column of every nonzero entry
+    std::vector<size_t> columnIndex;
+
+    //Every nonzero entry
+    std::vector<double> values;
+};
+
+//////// FUNCTIONS
+
+//True if a |rows| x |columns| matrix with |nonzeros| nonzero entries should be stored sparse
+bool sparseWorthwhile(const size_t rows, const size_t columns, const size_t nonzeros);
+
+//Return the number of nonzero entries in the |rows| x |columns| row-major |buffer|
+size_t countNonzeros(const size_t rows, const size_t columns, const double* buffer, const size_t stride);
+
+//Return |lhs| + |rhs|, or |lhs| - |rhs| when |subtract|, both must be of the same order
+SparseMatrix sparseSum(const SparseMatrix& lhs, const SparseMatrix& rhs, const bool subtract);
+
+//C = A * B for a sparse A and a dense B of |columns| columns, C must be zeroed
+void sparseDense(const SparseMatrix& A, const double* B, const size_t ldb, const size_t columns,
+                 double* C, const size_t ldc);
+
+//C = A * B for a dense A of |rows| rows and a sparse B, C must be zeroed
+void denseSparse(const size_t rows, const double* A, const size_t lda, const SparseMatrix& B,
+                 double* C, const size_t ldc);
+
+//Return A * B for a sparse A and a sparse B
+SparseMatrix sparseSparse(const SparseMatrix& A, const SparseMatrix& B);
+
+//Return the transpose of A
+SparseMatrix sparseTranspose(const SparseMatrix& A);
+
+//Return the elementwise product of A and the row-major B, whose rows are |ldb| entries apart
+SparseMatrix sparseHadamard(const SparseMatrix& A, const double* B, const size_t ldb);
+
+//Return the elementwise product of A and B
+SparseMatrix sparseHadamard(const SparseMatrix& A, const SparseMatrix& B);
+
+//Return the Kronecker product of A and B, each entry of A scales a copy of B
+SparseMatrix sparseKronecker(const SparseMatrix& A, const SparseMatrix& B);
+
+#endif //SPARSE_HPP_
@@ -0,0 +1,206 @@
+/*
+@Sean Siders
+sean.siders@icloud.com
+*/
+
+#include "Strassen.hpp"
+#include "Gemm.hpp"
+#include "Kernels.hpp"
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+//////// HELPERS
+
+//Z = X + Y, or Z = X - Y when |subtract|, over a |rows| x |columns| block
+static void combine(const size_t rows, const size_t columns, const double* X, const size_t ldx,
+                    const double* Y, const size_t ldy, double* Z, const size_t ldz, const bool subtract)
+{
+    const KernelTable& kernel = kernels();
+
+    for (size_t r = 0; r < rows; ++r)
+    {
+        if (subtract) kernel.difference(Z + r * ldz, X + r * ldx, Y + r * ldy, columns);
+        else kernel.sum(Z + r * ldz, X + r * ldx, Y + r * ldy, columns);
+    }
+}
+
+//Return the number of recursion levels an |m| x |k| by |k| x |n| product takes before reaching |crossover|
+static size_t depth(size_t m, size_t n, size_t k, const size_t crossover)
+{
+    size_t levels = 0;
+
+    while (m > crossover && n > crossover && k > crossover)
+    {
+        m /= 2;
+        n /= 2;
+        k /= 2;
+        ++levels;
+    }
+
+    return levels;
+}
+
+//Return the number of scratch entries the recursion needs for an |m| x |k| by |k| x |n| product
+static size_t workspaceSize(const size_t m, const size_t n, const size_t k, const size_t crossover)
+{
+    if (m <= crossover || n <= crossover || k <= crossover) return 0;
+
+    const size_t m2 = m / 2;
+    const size_t n2 = n / 2;
+    const size_t k2 = k / 2;
+
+    return 4 * m2 * k2 + 4 * k2 * n2 + 7 * m2 * n2 + workspaceSize(m2, n2, k2, crossover);
+}
+
+//One level of the recursion, every level takes its scratch from the front of |workspace|
+//and passes the rest down to the next level
+static void recurse(const size_t m, const size_t n, const size_t k, const double* A, const size_t lda,
+                    const double* B, const size_t ldb, double* C, const size_t ldc, const size_t crossover,
+                    double* workspace)
+{
+    if (m <= crossover || n <= crossover || k <= crossover)
+    {
+        gemm(m, n, k, 1.0, A, lda, B, ldb, 0.0, C, ldc);
+        return;
+    }
+
+    //The quadrants of the even part of every dimension
+    const size_t m2 = m / 2;
+    const size_t n2 = n / 2;
+    const size_t k2 = k / 2;
+
+    const double* A11 = A;
+    const double* A12 = A + k2;
+    const double* A21 = A + m2 * lda;
+    const double* A22 = A21 + k2;
+
+    const double* B11 = B;
+    const double* B12 = B + n2;
+    const double* B21 = B + k2 * ldb;
+    const double* B22 = B21 + n2;
+
+    double* C11 = C;
+    double* C12 = C + n2;
+    double* C21 = C + m2 * ldc;
+    double* C22 = C21 + n2;
+
+    //Scratch for the sums of A (|k2| wide), the sums of B (|n2| wide) and the 7 products (|n2| wide)
+    double* S1 = workspace;
+    double* S2 = S1 + m2 * k2;
+    double* S3 = S2 + m2 * k2;
+    double* S4 = S3 + m2 * k2;
+
+    double* T1 = S4 + m2 * k2;
+    double* T2 = T1 + k2 * n2;
+    double* T3 = T2 + k2 * n2;
+    double* T4 = T3 + k2 * n2;
+
+    double* P1 = T4 + k2 * n2;
+    double* P2 = P1 + m2 * n2;
+    double* P3 = P2 + m2 * n2;
+    double* P4 = P3 + m2 * n2;
+    double* P5 = P4 + m2 * n2;
+    double* P6 = P5 + m2 * n2;
+    double* P7 = P6 + m2 * n2;
+    double* next = P7 + m2 * n2;
+
+    //The 8 pre-additions
+    combine(m2, k2, A21, lda, A22, lda, S1, k2, false);
+    combine(m2, k2, S1, k2, A11, lda, S2, k2, true);
+    combine(m2, k2, A11, lda, A21, lda, S3, k2, true);
+    combine(m2, k2, A12, lda, S2, k2, S4, k2, true);
+
+    combine(k2, n2, B12, ldb, B11, ldb, T1, n2, true);
+    combine(k2, n2, B22, ldb, T1, n2, T2, n2, true);
+    combine(k2, n2, B22, ldb, B12, ldb, T3, n2, true);
+    combine(k2, n2, T2, n2, B21, ldb, T4, n2, true);
+
+    //The 7 half-size products
+    recurse(m2, n2, k2, A11, lda, B11, ldb, P1, n2, crossover, next);
+    recurse(m2, n2, k2, A12, lda, B21, ldb, P2, n2, crossover, next);
+    recurse(m2, n2, k2, S4, k2, B22, ldb, P3, n2, crossover, next);
+    recurse(m2, n2, k2, A22, lda, T4, n2, P4, n2, crossover, next);
+    recurse(m2, n2, k2, S1, k2, T1, n2, P5, n2, crossover, next);
+    recurse(m2, n2, k2, S2, k2, T2, n2, P6, n2, crossover, next);
+    recurse(m2, n2, k2, S3, k2, T3, n2, P7, n2, crossover, next);
+
+    //The 7 post-additions, reusing |P1| and |P6| once they are no longer needed
+    combine(m2, n2, P1, n2, P2, n2, C11, ldc, false);
+    combine(m2, n2, P1, n2, P6, n2, P1, n2, false);
+    combine(m2, n2, P1, n2, P7, n2, P6, n2, false);
+    combine(m2, n2, P1, n2, P5, n2, C12, ldc, false);
+    combine(m2, n2, C12, ldc, P3, n2, C12, ldc, false);
+    combine(m2, n2, P6, n2, P4, n2, C21, ldc, true);
+    combine(m2, n2, P6, n2, P5, n2, C22, ldc, false);
+
+    //Peel the odd row, column and rank-1 term left out of the quadrants
+    if (k > 2 * k2) gemm(2 * m2, 2 * n2, 1, 1.0, A + 2 * k2, lda, B + 2 * k2 * ldb, ldb, 1.0, C, ldc);
+    if (n > 2 * n2) gemm(m, 1, k, 1.0, A, lda, B + 2 * n2, ldb, 0.0, C + 2 * n2, ldc);
+    if (m > 2 * m2) gemm(1, 2 * n2, k, 1.0, A + 2 * m2 * lda, lda, B, ldb, 0.0, C + 2 * m2 * ldc, ldc);
+}
+
+//////// FUNCTIONS
+
+//Return the settings in use, disabled with a crossover of 512 by default
+StrassenSettings& strassenSettings()
+{
+    static StrassenSettings settings = {false, 512};
+    return settings;
+}
+
+//True if an |m| x |k| by |k| x |n| product should use the Strassen-Winograd recursion
+bool strassenWorthwhile(const size_t m, const size_t n, const size_t k)
+{
+    const StrassenSettings& settings = strassenSettings();
+
+    return settings.enabled && depth(m, n, k, settings.crossover) > 0;
+}
+
+//C = A * B with the Strassen-Winograd recursion down to |crossover|
+//A is |m| x |k|, B is |k| x |n| and C is |m| x |n|
+//The scratch of every level is allocated up front in one uninitialized block
+void strassen(const size_t m, const size_t n, const size_t k, const double* A, const size_t lda,
+              const double* B, const size_t ldb, double* C, const size_t ldc, const size_t crossover)
+{
+    std::unique_ptr<double[]> workspace(new double[workspaceSize(m, n, k, crossover)]);
+
+    recurse(m, n, k, A, lda, B, ldb, C, ldc, crossover, workspace.get());
+}
+
+//Compute A * B both ways, with the crossover of |strassenSettings| even while the mode is off
+//Return the difference and the time taken by each
+StrassenReport strassenAccuracy(const size_t m, const size_t n, const size_t k,
+                                const double* A, const size_t lda, const double* B, const size_t ldb)
+{
+    const size_t crossover = strassenSettings().crossover;
+
+    std::vector<double> classic(m * n);
+    std::vector<double> fast(m * n);
+
+    auto start = std::chrono::steady_clock::now();
+    gemm(m, n, k, 1.0, A, lda, B, ldb, 0.0, classic.data(), n);
+    auto classicEnd = std::chrono::steady_clock::now();
+    strassen(m, n, k, A, lda, B, ldb, fast.data(), n, crossover);
+    auto strassenEnd = std::chrono::steady_clock::now();
+
+    StrassenReport report = {0.0, 0.0, 0.0, 0.0, depth(m, n, k, crossover)};
+    double differenceNorm = 0.0;
+    double classicNorm = 0.0;
+
+    for (size_t i = 0; i < m * n; ++i)
+    {
+        const double difference = std::fabs(fast[i] - classic[i]);
+
+        if (difference > report.maxError) report.maxError = difference;
+        differenceNorm += difference * difference;
+        classicNorm += classic[i] * classic[i];
+    }
+
+    report.relativeError = (classicNorm > 0.0) ? std::sqrt(differenceNorm / classicNorm) : std::sqrt(differenceNorm);
+    report.classicSeconds = std::chrono::duration<double>(classicEnd - start).count();
+    report.strassenSeconds = std::chrono::duration<double>(strassenEnd - classicEnd).count();
+
+    return report;
+}
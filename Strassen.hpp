@@ -0,0 +1,69 @@
+/*
+Strassen-Winograd multiplication for large dense products. Each level of recursion splits A, B and C into quadrants and
+forms the product with 7 half-size multiplications and 15 additions, instead of the 8 multiplications of the classic
+algorithm. Below the crossover size the recursion stops and the blocked |gemm| engine takes over.
+
+ODD DIMENSIONS
+A level only recurses on the largest even part of each dimension. The leftover row, column and rank-1 term are
+computed with |gemm| (dynamic peeling), so matrices of any order are supported.
+
+ACCURACY
+The extra additions make Strassen slightly less accurate than the classic product, the error grows with the depth of
+the recursion. |strassenAccuracy| measures it for a given product. The mode is off by default.
+
+@Sean Siders
+sean.siders@icloud.com
+*/
+
+#ifndef STRASSEN_HPP_
+#define STRASSEN_HPP_
+
+#include <cstddef>
+
+//The Strassen-Winograd settings used by |Matrix| multiplication
+struct StrassenSettings
+{
+    //True if large products use the Strassen-Winograd recursion
+    bool enabled;
+
+    //The recursion stops once any dimension of a product is at or below this size
+    size_t crossover;
+};
+
+//The comparison of one Strassen-Winograd product against the classic product
+struct StrassenReport
+{
+    //The largest absolute difference between any two entries
+    double maxError;
+
+    //The Frobenius norm of the difference, relative to the Frobenius norm of the classic product
+    double relativeError;
+
+    //The wall time of each product in seconds
+    double classicSeconds;
+    double strassenSeconds;
+
+    //The number of recursion levels taken before the crossover
+    size_t levels;
+};
+
+//The smallest crossover accepted, below it the additions cost more than the multiplication they save
+const size_t STRASSEN_MIN_CROSSOVER = 16;
+
+//Return the settings in use, disabled with a crossover of 512 by default
+StrassenSettings& strassenSettings();
+
+//True if an |m| x |k| by |k| x |n| product should use the Strassen-Winograd recursion
+bool strassenWorthwhile(const size_t m, const size_t n, const size_t k);
+
+//C = A * B with the Strassen-Winograd recursion down to |crossover|
+//A is |m| x |k|, B is |k| x |n| and C is |m| x |n|
+void strassen(const size_t m, const size_t n, const size_t k, const double* A, const size_t lda,
+              const double* B, const size_t ldb, double* C, const size_t ldc, const size_t crossover);
+
+//Compute A * B both ways, with the crossover of |strassenSettings| even while the mode is off
+//Return the difference and the time taken by each
+StrassenReport strassenAccuracy(const size_t m, const size_t n, const size_t k,
+                                const double* A, const size_t lda, const double* B, const size_t ldb);
+
+#endif //STRASSEN_HPP_
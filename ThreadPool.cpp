@@ -0,0 +1,155 @@
+/*
+@Sean Siders
+sean.siders@icloud.com
+*/
+
+#include "ThreadPool.hpp"
+
+//True on a thread that is currently running a pool task
+static thread_local bool insideTask = false;
+
+//////// CONSTRUCTORS
+
+//Start a pool of |threads| threads in total, including the calling thread
+ThreadPool::ThreadPool(const size_t threads) :
+    task(nullptr), taskCount(0), nextTask(0), generation(0), active(0), stopping(false)
+{
+    start(threads ? threads - 1 : 0);
+}
+
+//////// DESTRUCTOR
+
+//Stop and join every worker
+ThreadPool::~ThreadPool()
+{
+    stop();
+}
+
+//////// PUBLIC FUNCTIONS
+
+//Return the number of threads that run tasks, including the calling thread
+size_t ThreadPool::size() const
+{
+    return workers.size() + 1;
+}
+
+//Stop the current workers and start a pool of |threads| threads in total
+//A |threads| of 0 is treated as 1
+void ThreadPool::resize(const size_t threads)
+{
+    stop();
+    start(threads ? threads - 1 : 0);
+}
+
+//Run |task| once for every index in [0, |count|), then return
+void ThreadPool::run(const size_t count, const std::function<void(size_t)>& task)
+{
+    //Nothing to share, or called from within a task : run serially on this thread
+    if (workers.empty() || count < 2 || insideTask)
+    {
+        for (size_t i = 0; i < count; ++i) task(i);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        this->task = &task;
+        taskCount = count;
+        nextTask = 0;
+        active = workers.size();
+        ++generation;
+    }
+
+    wake.notify_all();
+
+    //The calling thread works through the batch as well
+    execute();
+
+    //Every worker must leave the batch before |task| goes out of scope
+    std::unique_lock<std::mutex> guard(lock);
+    done.wait(guard, [this] { return 0 == active; });
+    this->task = nullptr;
+}
+
+//////// PRIVATE FUNCTIONS
+
+//Start |count| worker threads
+void ThreadPool::start(const size_t count)
+{
+    stopping = false;
+
+    //The current generation is handed to each worker, a batch posted before a worker first runs is still new to it
+    for (size_t i = 0; i < count; ++i) workers.emplace_back(&ThreadPool::work, this, generation);
+}
+
+//Signal every worker to exit and join them
+void ThreadPool::stop()
+{
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        stopping = true;
+    }
+
+    wake.notify_all();
+
+    for (std::thread& worker : workers) worker.join();
+
+    workers.clear();
+}
+
+//The loop each worker thread runs until |stopping|, |seen| is the last batch posted before the worker started
+void ThreadPool::work(size_t seen)
+{
+    std::unique_lock<std::mutex> guard(lock);
+
+    while (true)
+    {
+        wake.wait(guard, [this, seen] { return stopping || generation != seen; });
+
+        if (stopping) return;
+
+        seen = generation;
+
+        guard.unlock();
+        execute();
+        guard.lock();
+
+        //Leaving the batch
+        if (0 == --active) done.notify_one();
+    }
+}
+
+//Claim and run tasks of the current batch until none are left
+void ThreadPool::execute()
+{
+    insideTask = true;
+
+    for (size_t i = nextTask++; i < taskCount; i = nextTask++) (*task)(i);
+
+    insideTask = false;
+}
+
+//////// FUNCTIONS
+
+//Return the pool shared by every matrix operation, sized to the hardware on the first call
+ThreadPool& threadPool()
+{
+    static ThreadPool pool(std::thread::hardware_concurrency());
+    return pool;
+}
+
+//Split [0, |count|) into contiguous ranges and run |body| on each range across the pool
+//|work| estimates the total cost, below |PARALLEL_THRESHOLD| |body| runs once on the calling thread
+void parallelFor(const size_t count, const size_t work, const std::function<void(size_t, size_t)>& body)
+{
+    ThreadPool& pool = threadPool();
+    const size_t ranges = (count < pool.size()) ? count : pool.size();
+
+    if (work < PARALLEL_THRESHOLD || ranges < 2)
+    {
+        if (count) body(0, count);
+        return;
+    }
+
+    pool.run(ranges, [&](size_t i) { body(count * i / ranges, count * (i + 1) / ranges); });
+}
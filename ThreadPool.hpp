@@ -0,0 +1,115 @@
+/*
+A fixed set of worker threads shared by every |Matrix| operation. Work is handed to the pool as a count of independent
+tasks, the calling thread takes part in running them, and |run| returns only when every task has finished.
+
+DETERMINISM
+Tasks only ever split the output into disjoint row blocks or tiles, and every entry is still computed by one thread
+in the same order as the serial code. Results are identical for any pool size.
+
+NESTING
+A task that calls |run| again executes the inner tasks serially on its own thread, so the pool can never deadlock.
+
+@Sean Siders
+sean.siders@icloud.com
+*/
+
+#ifndef THREAD_POOL_HPP_
+#define THREAD_POOL_HPP_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//Operations with less work than this (entries or multiply-adds) are not worth waking the pool for
+const size_t PARALLEL_THRESHOLD = 1 << 16;
+
+class ThreadPool
+{
+    public:
+    //////// CONSTRUCTORS
+
+    //Start a pool of |threads| threads in total, including the calling thread
+    explicit ThreadPool(const size_t threads);
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    //////// DESTRUCTOR
+
+    //Stop and join every worker
+    ~ThreadPool();
+
+    //////// PUBLIC FUNCTIONS
+
+    //Return the number of threads that run tasks, including the calling thread
+    size_t size() const;
+
+    //Stop the current workers and start a pool of |threads| threads in total
+    //A |threads| of 0 is treated as 1
+    void resize(const size_t threads);
+
+    //Run |task| once for every index in [0, |count|), then return
+    void run(const size_t count, const std::function<void(size_t)>& task);
+
+    private:
+    //////// DATA
+
+    //The worker threads, the calling thread is not included
+    std::vector<std::thread> workers;
+
+    //Guards every member below that is not atomic
+    std::mutex lock;
+
+    //Signalled when a new batch of tasks is posted, or the workers should stop
+    std::condition_variable wake;
+
+    //Signalled when a worker leaves a batch
+    std::condition_variable done;
+
+    //The task of the current batch
+    const std::function<void(size_t)>* task;
+
+    //The number of tasks in the current batch
+    size_t taskCount;
+
+    //The next unclaimed task index of the current batch
+    std::atomic<size_t> nextTask;
+
+    //Incremented every time a batch is posted, so workers can tell a new batch from a spurious wake
+    size_t generation;
+
+    //The number of workers still inside the current batch
+    size_t active;
+
+    //True when the workers should exit
+    bool stopping;
+
+    //////// PRIVATE FUNCTIONS
+
+    //Start |count| worker threads
+    void start(const size_t count);
+
+    //Signal every worker to exit and join them
+    void stop();
+
+    //The loop each worker thread runs until |stopping|, |seen| is the last batch posted before the worker started
+    void work(size_t seen);
+
+    //Claim and run tasks of the current batch until none are left
+    void execute();
+};
+
+//////// FUNCTIONS
+
+//Return the pool shared by every matrix operation, sized to the hardware on the first call
+ThreadPool& threadPool();
+
+//Split [0, |count|) into contiguous ranges and run |body| on each range across the pool
+//|work| estimates the total cost, below |PARALLEL_THRESHOLD| |body| runs once on the calling thread
+void parallelFor(const size_t count, const size_t work, const std::function<void(size_t, size_t)>& body);
+
+#endif //THREAD_POOL_HPP_
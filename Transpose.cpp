@@ -0,0 +1,110 @@
+/*
+@Sean Siders
+sean.siders@icloud.com
+*/
+
+#include "Transpose.hpp"
+#include "ThreadPool.hpp"
+#include <utility>
+
+//////// HELPERS
+
+//B = transpose(A) for a |rows| x |columns| block, halving the larger dimension until a tile remains
+static void copyBlock(const size_t rows, const size_t columns, const double* A, const size_t lda,
+                      double* B, const size_t ldb)
+{
+    if (rows <= TRANSPOSE_BLOCK && columns <= TRANSPOSE_BLOCK)
+    {
+        for (size_t r = 0; r < rows; ++r)
+        {
+            for (size_t c = 0; c < columns; ++c) B[c * ldb + r] = A[r * lda + c];
+        }
+
+        return;
+    }
+
+    if (rows >= columns)
+    {
+        const size_t half = rows / 2;
+
+        copyBlock(half, columns, A, lda, B, ldb);
+        copyBlock(rows - half, columns, A + half * lda, lda, B + half, ldb);
+    }
+
+    else
+    {
+        const size_t half = columns / 2;
+
+        copyBlock(rows, half, A, lda, B, ldb);
+        copyBlock(rows, columns - half, A + half, lda, B + half * ldb, ldb);
+    }
+}
+
+//Swap the |rows| x |columns| block A with the transpose of the |columns| x |rows| block B, both rows |ld| entries apart
+//The blocks are the two off diagonal quarters of a square being transposed in place, they never overlap
+static void swapBlocks(const size_t rows, const size_t columns, double* A, double* B, const size_t ld)
+{
+    if (rows <= TRANSPOSE_BLOCK && columns <= TRANSPOSE_BLOCK)
+    {
+        for (size_t r = 0; r < rows; ++r)
+        {
+            for (size_t c = 0; c < columns; ++c) std::swap(A[r * ld + c], B[c * ld + r]);
+        }
+
+        return;
+    }
+
+    if (rows >= columns)
+    {
+        const size_t half = rows / 2;
+
+        swapBlocks(half, columns, A, B, ld);
+        swapBlocks(rows - half, columns, A + half * ld, B + half, ld);
+    }
+
+    else
+    {
+        const size_t half = columns / 2;
+
+        swapBlocks(rows, half, A, B, ld);
+        swapBlocks(rows, columns - half, A + half, B + half * ld, ld);
+    }
+}
+
+//////// FUNCTIONS
+
+//Write the transpose of the |rows| x |columns| row-major A, whose rows are |lda| entries apart, into B
+//Large transposes are split into bands of rows across the thread pool, each band is transposed recursively
+void transposeCopy(const size_t rows, const size_t columns, const double* A, const size_t lda, double* B, const size_t ldb)
+{
+    const size_t bands = (rows + TRANSPOSE_BLOCK - 1) / TRANSPOSE_BLOCK;
+
+    parallelFor(bands, rows * columns, [&](size_t begin, size_t end)
+    {
+        const size_t first = begin * TRANSPOSE_BLOCK;
+        const size_t last = (end * TRANSPOSE_BLOCK < rows) ? end * TRANSPOSE_BLOCK : rows;
+
+        copyBlock(last - first, columns, A + first * lda, lda, B + first, ldb);
+    });
+}
+
+//Transpose the |order| x |order| row-major A, whose rows are |lda| entries apart, in place
+//[A11 A12; A21 A22] becomes [A11' A21'; A12' A22']
+void transposeSquare(const size_t order, double* A, const size_t lda)
+{
+    if (order <= TRANSPOSE_BLOCK)
+    {
+        for (size_t r = 0; r < order; ++r)
+        {
+            for (size_t c = r + 1; c < order; ++c) std::swap(A[r * lda + c], A[c * lda + r]);
+        }
+
+        return;
+    }
+
+    const size_t half = order / 2;
+
+    transposeSquare(half, A, lda);
+    transposeSquare(order - half, A + half * lda + half, lda);
+    swapBlocks(half, order - half, A + half, A + half * lda, lda);
+}
@@ -0,0 +1,36 @@
+/*
+Cache-oblivious transposes of row-major buffers. A naive transpose reads one matrix by rows and writes the other by
+columns, so for large matrices every write lands on a different page and the transpose is bound by TLB and cache misses.
+
+RECURSION
+The larger dimension is halved until a tile of at most |TRANSPOSE_BLOCK| x |TRANSPOSE_BLOCK| entries remains, and only
+that tile is transposed directly. At some depth of the recursion the tiles fit every level of cache and the TLB, whatever
+their sizes are, so no block size has to be tuned for the machine.
+
+IN PLACE
+A square buffer is transposed in place by transposing its two diagonal quarters recursively and swapping the off
+diagonal quarters with each other's transpose, so no second buffer is needed.
+
+Products never need a transpose to be formed, |gemm| reads a transposed operand as a view, see |Gemm.hpp|.
+
+@Sean Siders
+sean.siders@icloud.com
+*/
+
+#ifndef TRANSPOSE_HPP_
+#define TRANSPOSE_HPP_
+
+#include <cstddef>
+
+//The order of the largest tile the recursion transposes directly
+//Both tiles of a pair, read and written, fit in the L1 cache
+const size_t TRANSPOSE_BLOCK = 32;
+
+//Write the transpose of the |rows| x |columns| row-major A, whose rows are |lda| entries apart, into B
+//B is |columns| x |rows| with rows |ldb| entries apart, and must not overlap A
+void transposeCopy(const size_t rows, const size_t columns, const double* A, const size_t lda, double* B, const size_t ldb);
+
+//Transpose the |order| x |order| row-major A, whose rows are |lda| entries apart, in place
+void transposeSquare(const size_t order, double* A, const size_t lda);
+
+#endif //TRANSPOSE_HPP_
@@ -17,6 +17,33 @@ RED BLACK TREE PROPERTIES
 - The longest path to a leaf is no more than twice the length of the shortest path to a leaf
 - Complexity is O(log N)
 
+ITERATION
+Every operation runs in a loop rather than by recursion. Nodes keep a pointer to their parent, so insertion rebalances
+by walking back up, and in order traversal steps from each node to its successor. The preorder read and write of the
+datafile use an explicit stack of at most the height of the tree.
+
+LOADING
+The datafile does not record colors, so the nodes read in are relinked in order as a balanced tree and colored from
+their depth : every level is black except an incomplete last level, which is red. Any file, even one written by hand
+in the shape of a list, loads as a valid red-black tree.
+
+MEMORY
+Each node holds its data inline, and the nodes are drawn from an |ObjectPool| owned by the tree (see |Pool.hpp|), so
+loading or defining many matrices allocates a few slabs rather than a block per matrix. The tree destroys the nodes and
+frees the slabs all at once when it is destroyed.
+
+NODE LAYOUT
+A node is aligned to a cache line, with its links and color first and its data right after them. The data begins with
+its key, so a comparison during a lookup reads the child pointers and the key from a single cache line, and for a
+|Matrix| with a short identifier the characters of the key as well. Nodes never move once created, so pointers to their
+data stay valid while they are in the tree.
+
+DELETION
+A removed node is unlinked and destroyed at once, so its data releases whatever it owns right away and its slot goes
+back to the pool for the next node. A node with two children trades places with its successor by relinking, the data
+is never moved. Removing a black node leaves its paths one black node short, which is repaired by recoloring and at
+most three rotations while walking back up.
+
 REQUIRED OPERATOR OVERLOADS
 bool operator< | bool operator> : for sorting operations
 std::ostream& operator<< : for displaying from this tree
@@ -29,8 +56,12 @@ sean.siders@icloud.com
 #ifndef TABLE_HPP_
 #define TABLE_HPP_
 
+#include <algorithm>
 #include <iostream>
 #include <fstream>
+#include <utility>
+#include <vector>
+#include "Pool.hpp"
 
 //// FORWARD DECLARATIONS
 
@@ -56,40 +87,20 @@ enum ColorBit
 
 //////// RED BLACK NODE
 
+//The alignment of every node, one cache line
+const size_t NODE_ALIGNMENT = 64;
+
 template <typename T>
-class Node
+class alignas(NODE_ALIGNMENT) Node
 {
     public:
 
     //////// CONSTRUCTORS 
 
-    Node() : left(nullptr), right(nullptr), data(nullptr), color(RED) {}
-
-    //Parameterized to take in the |source| data that this node will manage
-    Node(const T& source) : left(nullptr), right(nullptr), data(nullptr), color(RED)
-    {
-        data = new T(source);
-    }
-
-    Node(std::ifstream& inFile) : left(nullptr), right(nullptr), data(nullptr)
-    {
-        data = new T(inFile);
-        inFile.ignore(1, '\n');
-    }
-
-    //////// DESTRUCTOR 
-
-    //Recursive tree deallocation
-    ~Node()
-    {
-        delete data;
-        data = nullptr;
-
-        delete left;
-        delete right;
-        left = nullptr;
-        right = nullptr;
-    }
+    //Construct the data this node manages in place from |args|
+    template <typename... Args>
+    explicit Node(std::in_place_t, Args&&... args) :
+        left(nullptr), right(nullptr), parent(nullptr), color(RED), data(std::forward<Args>(args)...) {}
 
     //////// PUBLIC FUNCTIONS 
 
@@ -97,14 +108,14 @@ class Node
     template <typename K = T>
     bool lessThan(const K& other) const
     {
-        return (data ? *data > other : false);
+        return data > other;
     }
 
     //True if |other| is greater than this node's data
     template <typename K = T>
     bool greaterThan(const K& other) const
     {
-        return (data ? *data < other : false);
+        return data < other;
     }
 
     //True if this node has no children
@@ -125,10 +136,16 @@ class Node
         color = (color == RED ? BLACK : RED);
     }
 
+    //Set the color of this node
+    void setColor(const ColorBit _color)
+    {
+        color = _color;
+    }
+
     //Display the data of this node using |out|
     void display(std::ostream& out = std::cout) const
     {
-        if (data) out << *data;
+        out << data;
     }
 
     //Display the color of this node (for debugging purposes)
@@ -140,7 +157,7 @@ class Node
     //Write the data in this node to |outFile|
     void writeFile(std::ofstream& outFile) const
     {
-        if (data) outFile << *data;
+        outFile << data;
 
         outFile << '\n' << (left ? '1' : '0') << ' '
         << (right ? '1' : '0') << '\n';
@@ -158,9 +175,14 @@ class Node
         return right;
     }
 
+    Node* _parent() const
+    {
+        return parent;
+    }
+
     T* _data()
     {
-        return data;
+        return &data;
     }
 
     void setLeft(Node* _left)
@@ -173,6 +195,11 @@ class Node
         right = _right;
     }
 
+    void setParent(Node* _parent)
+    {
+        parent = _parent;
+    }
+
     private:
 
     //////// DATA 
@@ -183,11 +210,14 @@ class Node
     //The right child of this node
     Node* right;
 
-    //The data this node manages (dynamically allocated)
-    T* data;
+    //The parent of this node, null for the root
+    Node* parent;
 
     //The color of this node (RED or BLACK)
     ColorBit color;
+
+    //The data this node manages, on the same cache line as the links above
+    T data;
 };
 
 template <typename T>
@@ -208,6 +238,9 @@ class Tree
 
     Tree() : root(nullptr), nodeCount(0), filename(nullptr) {}
 
+    Tree(const Tree&) = delete;
+    Tree& operator=(const Tree&) = delete;
+
     //A |_filename| to an external database was provided
     //Read in the data from the file, populating the tree
     Tree(const char* _filename) : root(nullptr), nodeCount(0), filename(_filename)
@@ -218,7 +251,13 @@ class Tree
             inFile >> nodeCount;
 
             if (inFile.eof()) nodeCount = 0;
-            else readFile(root, inFile);
+            else
+            {
+                //The nodes are drawn from as few slabs as possible
+                nodes.reserve(std::min(nodeCount, POOL_LARGEST_SLAB));
+
+                readFile(inFile);
+            }
 
             inFile.clear();
             inFile.close();
@@ -230,7 +269,7 @@ class Tree
     ~Tree()
     {
         //If an external file was provided
-        //Write out to the file and recursively deallocate the tree
+        //Write out to the file before deallocating the tree
         if (filename)
         {
             std::ofstream outFile(filename);
@@ -245,41 +284,69 @@ class Tree
             outFile.close();
         }
 
-        //Otherwise just deallocate
-        //Recursive dellocation occurs in the Node destructor
-        delete root;
+        //Destroy the nodes, then free every slab at once
+        destroyNodes(root);
         root = nullptr;
+
+        nodes.release();
     }
 
     //////// PUBLIC FUNCTIONS 
 
-    //Insert |source| into the tree
+    //Insert a copy of |source| into the tree
     //Various mutations occur in the recursive call to maintain red-black tree properties
     //Return a pointer to the inserted data
     T* insert(const T& source)
     {
-        //Increment node count
-        ++nodeCount;
-
-        //Empty Tree
-        if (!root)
-        {
-            //Allocate and make root black
-            root = new Node<T>(source);
-            root->recolor();
-            return root->_data();
-        }
-
-        bool path[2] = {false, false};
-        Node<T>* parent = nullptr;
+        return emplace(source);
+    }
 
-        return insert(root, source, path, parent);
+    //Move |source| into the tree, no copy of its data is made
+    //Return a pointer to the inserted data
+    T* insert(T&& source)
+    {
+        return emplace(std::move(source));
     }
 
+    //Return the data whose key equals |key|, or null if there is none
     template <typename K = T>
     T* retrieve(const K& key) const
     {
-        return retrieve(root, key);
+        Node<T>* node = find(key);
+        return node ? node->_data() : nullptr;
+    }
+
+    //Remove the data whose key equals |key| from the tree and destroy it
+    //Return false if there is none
+    template <typename K = T>
+    bool remove(const K& key)
+    {
+        Node<T>* node = find(key);
+        if (!node) return false;
+
+        erase(node);
+        return true;
+    }
+
+    //Remove and destroy the data of each node in order, from the first whose key is not less than |first|, for as long
+    //as |matches| is true of its data
+    //Return the number of items removed
+    template <typename K, typename Predicate>
+    size_t removeFrom(const K& first, Predicate matches)
+    {
+        size_t removed = 0;
+        Node<T>* node = lowerBound(first);
+
+        //Nodes are relinked rather than moved, so the successor found before an erase is still in the tree after it
+        while (node && matches(*node->_data()))
+        {
+            Node<T>* following = next(node);
+            erase(node);
+            node = following;
+            ++removed;
+        }
+
+        return removed;
     }
 
     //Return the number of nodes / items in the tree
@@ -288,9 +355,21 @@ class Tree
         return nodeCount;
     }
 
+    //Display every item in order, from smallest key to largest
     void displayInorder(std::ostream& out = std::cout) const
     {
-        displayInorder(root, out);
+        for (Node<T>* node = first(root); node; node = next(node))
+        {
+            node->display(out);
+            out << '\n';
+        }
+    }
+
+    //Call |visit| with the data of every item in order, from smallest key to largest
+    template <typename Visit>
+    void forEach(Visit visit)
+    {
+        for (Node<T>* node = first(root); node; node = next(node)) visit(*node->_data());
     }
 
     //Display in preorder traversal showing the level, data, and color of each node
@@ -319,207 +398,333 @@ class Tree
     //The data structure will read in / write out to the specified file
     const char* filename;
 
-    //////// PRIVATE FUNCTIONS 
+    //The slabs the nodes are drawn from
+    ObjectPool<Node<T>> nodes;
 
-    //Traverse with |root| to the null leaf where |source| belongs
-    //Allocate and set the new node's |parent|
-    //Make the necessary mutations to the tree to remain balanced
+    //////// PRIVATE FUNCTIONS 
 
-    //|path| contains information for |root| to grand child
-    //true = left : false = right
-    //index 0 : child path
-    //index 1 : grandchild path
+    //Return a new red node managing data constructed from |args|
+    template <typename... Args>
+    Node<T>* createNode(Args&&... args)
+    {
+        return nodes.create(std::in_place, std::forward<Args>(args)...);
+    }
 
-    //Return a pointer to the new data
-    T* insert(Node<T>*& root, const T& source, bool path[2], Node<T>*& parent)
+    //Destroy every node beneath and including |root|
+    //Each node is destroyed once its children are on the stack, it is never visited again
+    void destroyNodes(Node<T>* root)
     {
-        //At the null leaf
-        if (!root)
+        std::vector<Node<T>*> pending;
+        if (root) pending.push_back(root);
+
+        while (!pending.empty())
         {
-            //Allocate the new node with |source|
-            root = new Node<T>(source);
-            return root->_data();
+            Node<T>* node = pending.back();
+            pending.pop_back();
+
+            if (node->_left()) pending.push_back(node->_left());
+            if (node->_right()) pending.push_back(node->_right());
+
+            nodes.destroy(node);
         }
+    }
 
-        //The pointer to return
-        T* sourceptr = nullptr;
+    //Return the node whose key equals |key|, or null if there is none
+    template <typename K>
+    Node<T>* find(const K& key) const
+    {
+        Node<T>* node = root;
 
-        //If |source| key is less than root's key, go left
-        if (root->lessThan(source))
+        while (node)
         {
-            sourceptr = insert(root->_left(), source, path, parent);
+            //|key| is less than the node's key
+            if (node->lessThan(key)) node = node->_left();
 
-            //|root| is now the parent of |x| : set |parent| and |path|
-            if (!parent)
-            {
-                path[0] = true;
-                parent = root;
-            }
-            
-            //|root| is now the grandparent of |x| : set |path|
-            //Perform the necessary mutations
-            else
-            {
-                path[1] = true;
-                updateTree(root, path, parent);
-            }
+            //|key| is greater than the node's key
+            else if (node->greaterThan(key)) node = node->_right();
+
+            //|key| is equal to the node's key
+            else return node;
         }
 
-        //|source| key is greater than root's key, go right
-        else
-        {
-            sourceptr = insert(root->_right(), source, path, parent);
+        return nullptr;
+    }
 
-            //|root| is now the parent of |x| : set |parent| and |path|
-            if (!parent)
-            {
-                path[0] = false;
-                parent = root;
-            }
-            
-            //|root| is now the grandparent of |x| : set |path|
-            //Perform the necessary mutations
+    //Return the first node in order whose key is not less than |key|, or null if there is none
+    template <typename K>
+    Node<T>* lowerBound(const K& key) const
+    {
+        Node<T>* bound = nullptr;
+        Node<T>* node = root;
+
+        while (node)
+        {
+            if (node->greaterThan(key)) node = node->_right();
             else
             {
-                path[1] = false;
-                updateTree(root, path, parent);
+                bound = node;
+                node = node->_left();
             }
         }
 
-        return sourceptr;
+        return bound;
+    }
+
+    //True if |node| is black, null leaves are black
+    static bool isBlack(const Node<T>* node)
+    {
+        return !node || !node->isRed();
+    }
+
+    //Return the node with the smallest key beneath and including |root|, or null if |root| is null
+    static Node<T>* first(Node<T>* root)
+    {
+        if (root) while (root->_left()) root = root->_left();
+
+        return root;
+    }
+
+    //Return the node that follows |node| in order, or null if |node| is the last
+    //The successor is the first node of the right subtree, or else the nearest ancestor |node| is to the left of
+    static Node<T>* next(Node<T>* node)
+    {
+        if (node->_right()) return first(node->_right());
+
+        Node<T>* parent = node->_parent();
+
+        while (parent && node == parent->_right())
+        {
+            node = parent;
+            parent = parent->_parent();
+        }
+
+        return parent;
     }
 
-    //|grandparent| : the current |root| in insert
-    //|path| : the path from |grandparent| to |x| : true = left / false = right
-    //|parent| the child of grandparent on the path to |x|
-    //This function is called every 3rd node in head recursion of the insert procedure
-    //Various cases are checked to evaluate whether the tree is still a proper red-black tree
-    //If not, the necessary mutations
-    void updateTree(Node<T>*& grandparent, bool path[2], Node<T>*& parent)
+    //Insert |source| into the tree, copying or moving it into the new node as it was passed
+    //|source| is only copied or moved once, into the new node at the null leaf
+    //Return a pointer to the inserted data
+    template <typename U>
+    T* emplace(U&& source)
     {
-        //Find |x| based on the provided |path|
-        Node<T>* x = (path[0] ? parent->_left() : parent->_right());
+        //Walk down to the null leaf where |source| belongs
+        Node<T>* parent = nullptr;
+        Node<T>** link = &root;
 
-        //If the parent of |x| is black, nothing needs to be done
-        if (!parent->isRed() || !x->isRed())
+        while (*link)
         {
-            parent = nullptr;
-            return;
+            parent = *link;
+            link = parent->lessThan(source) ? &parent->_left() : &parent->_right();
         }
 
-        //Find the uncle of |x| based of |path| to |parent|
-        Node<T>* uncle = (path[1] ? grandparent->_right() : grandparent->_left());
+        Node<T>* x = createNode(std::forward<U>(source));
+        x->setParent(parent);
+        *link = x;
+
+        //Increment node count
+        ++nodeCount;
 
-        //If |uncle| of |x| is null or black
-        if (!uncle || !uncle->isRed())
+        balanceInsert(x);
+        return x->_data();
+    }
+
+    //Restore the red-black properties after the red node |x| was inserted
+    //While the parent of |x| is red :
+    //  - A red uncle : the parent and uncle turn black, the grandparent red, and the grandparent is the new |x|
+    //  - A black uncle : rotations about the parent and grandparent move |x| or its parent to the grandparent's place,
+    //    which turns black with two red children
+    void balanceInsert(Node<T>* x)
+    {
+        while (x->_parent() && x->_parent()->isRed())
         {
-            //path to |x| is left->left
-            if (path[1] && path[0])
-            {
-                grandparent->recolor();
-                parent->recolor();
-                rotateRight(grandparent);
-            }
+            Node<T>* parent = x->_parent();
+
+            //A red parent is never the root, so the grandparent exists
+            Node<T>* grandparent = parent->_parent();
+            const bool parentIsLeft = (parent == grandparent->_left());
+            Node<T>* uncle = parentIsLeft ? grandparent->_right() : grandparent->_left();
 
-            //path to |x| is right->left
-            else if (!path[1] && path[0])
+            //|uncle| of |x| is red
+            if (uncle && uncle->isRed())
             {
-                rotateRight(grandparent->_right());
-                grandparent->recolor();
-                grandparent->_right()->recolor();
-                rotateLeft(grandparent);
+                parent->setColor(BLACK);
+                uncle->setColor(BLACK);
+                grandparent->setColor(RED);
+                x = grandparent;
+                continue;
             }
 
-            //path to |x| is right->right
-            else if (!path[1] && !path[0])
+            //path to |x| is left->right or right->left, rotate it into left->left or right->right
+            if (parentIsLeft && x == parent->_right())
             {
-                grandparent->recolor();
-                parent->recolor();
-                rotateLeft(grandparent);
+                rotateLeft(parent);
+                parent = x;
             }
-
-            //path to |x| is left->right
-            else
+            else if (!parentIsLeft && x == parent->_left())
             {
-                rotateLeft(grandparent->_left());
-                grandparent->recolor();
-                grandparent->_left()->recolor();
-                rotateRight(grandparent);
+                rotateRight(parent);
+                parent = x;
             }
+
+            parent->setColor(BLACK);
+            grandparent->setColor(RED);
+
+            if (parentIsLeft) rotateRight(grandparent);
+            else rotateLeft(grandparent);
+
+            //The subtree is rooted at a black node again
+            break;
         }
 
-        //|uncle| of |x| is red
+        root->setColor(BLACK);
+    }
+
+    //Unlink |z| from the tree and destroy it, its data is released immediately
+    //A node with two children is replaced by its successor, which is relinked into its place rather than having its
+    //data moved, so pointers to the data of every other node stay valid
+    void erase(Node<T>* z)
+    {
+        //|x| takes the place of the node removed from its position, it may be null so its parent is kept apart
+        Node<T>* x = nullptr;
+        Node<T>* xParent = nullptr;
+        bool removedBlack = !z->isRed();
+
+        if (!z->_left() || !z->_right())
+        {
+            x = z->_left() ? z->_left() : z->_right();
+            xParent = z->_parent();
+            replaceChild(z->_parent(), z, x);
+        }
         else
         {
-            parent->recolor();
-            uncle->recolor();
+            //The successor has no left child, it leaves its own position to its right child
+            Node<T>* y = first(z->_right());
+            removedBlack = !y->isRed();
+            x = y->_right();
 
-            //Only recolor |grandparent| if it is not the true root
-            if (grandparent != this->root) grandparent->recolor();
+            if (y->_parent() == z) xParent = y;
+            else
+            {
+                xParent = y->_parent();
+                replaceChild(y->_parent(), y, x);
+                y->setRight(z->_right());
+                y->_right()->setParent(y);
+            }
+
+            replaceChild(z->_parent(), z, y);
+            y->setLeft(z->_left());
+            y->_left()->setParent(y);
+            y->setColor(z->isRed() ? RED : BLACK);
         }
 
-        //|grandparent| is now the new |x|
-        //The new parent must be found
-        parent = nullptr;
+        nodes.destroy(z);
+        --nodeCount;
+
+        if (removedBlack) balanceErase(x, xParent);
     }
 
-    //Rotate |root| to the right
-    static void rotateRight(Node<T>*& root)
+    //Restore the red-black properties after a black node was removed from above |x|, whose parent is |parent|
+    //Paths through |x| are one black node short. While |x| is black and not the root, with |w| its sibling :
+    //  - A red sibling : rotate it above the parent, so the sibling is black
+    //  - A black sibling with black children : the sibling turns red, and the parent is the new |x|
+    //  - A black sibling with a red child on the far side : rotate the sibling above the parent, and the far child
+    //    turns black to make up the missing black node
+    //  - A black sibling with a red child on the near side only : rotate that child above the sibling first
+    void balanceErase(Node<T>* x, Node<T>* parent)
     {
-        //Hold onto the root
-        Node<T>* newRight = root;
+        while (x != root && isBlack(x))
+        {
+            //|x| is short a black node, so its sibling subtree has at least one and the sibling exists
+            const bool xIsLeft = (x == parent->_left());
+            Node<T>* w = xIsLeft ? parent->_right() : parent->_left();
 
-        //Push up the left child as the new root
-        root = root->_left();
+            if (w->isRed())
+            {
+                w->setColor(BLACK);
+                parent->setColor(RED);
 
-        //Adopt the new root's right subtree as the left subtree
-        newRight->setLeft(root->_right());
+                if (xIsLeft) rotateLeft(parent);
+                else rotateRight(parent);
 
-        //Adopt the old root as the right child
-        root->setRight(newRight);
-    }
+                w = xIsLeft ? parent->_right() : parent->_left();
+            }
 
-    //Rotate |root| to the left
-    static void rotateLeft(Node<T>*& root)
-    {
-        //Hold onto the root
-        Node<T>* newLeft = root;
+            Node<T>* near = xIsLeft ? w->_left() : w->_right();
+            Node<T>* far = xIsLeft ? w->_right() : w->_left();
 
-        //Push up the right child as the new root
-        root = root->_right();
+            if (isBlack(near) && isBlack(far))
+            {
+                w->setColor(RED);
+                x = parent;
+                parent = x->_parent();
+                continue;
+            }
 
-        //Adopt the new root's left subtree as the right subtree
-        newLeft->setRight(root->_left());
+            if (isBlack(far))
+            {
+                near->setColor(BLACK);
+                w->setColor(RED);
 
-        //Adopt the old root as the left child
-        root->setLeft(newLeft);
+                if (xIsLeft) rotateRight(w);
+                else rotateLeft(w);
+
+                w = xIsLeft ? parent->_right() : parent->_left();
+                far = xIsLeft ? w->_right() : w->_left();
+            }
+
+            w->setColor(parent->isRed() ? RED : BLACK);
+            parent->setColor(BLACK);
+            far->setColor(BLACK);
+
+            if (xIsLeft) rotateLeft(parent);
+            else rotateRight(parent);
+
+            x = root;
+        }
+
+        if (x) x->setColor(BLACK);
     }
 
-    template <typename K = T>
-    static T* retrieve(Node<T>* root, const K& key)
+    //Point the link that held |oldChild| beneath |parent|, or the root if |parent| is null, to |newChild|
+    void replaceChild(Node<T>* parent, Node<T>* oldChild, Node<T>* newChild)
     {
-        if (!root) return nullptr;
+        if (!parent) root = newChild;
+        else if (oldChild == parent->_left()) parent->setLeft(newChild);
+        else parent->setRight(newChild);
+
+        if (newChild) newChild->setParent(parent);
+    }
 
-        //|key| is less than root's key
-        if (root->lessThan(key)) return retrieve(root->_left(), key);
+    //Rotate |x| to the right, its left child takes its place
+    void rotateRight(Node<T>* x)
+    {
+        //Push up the left child as the new root of the subtree
+        Node<T>* newRoot = x->_left();
+        replaceChild(x->_parent(), x, newRoot);
 
-        //|key| is greater than root's key
-        else if (root->greaterThan(key)) return retrieve(root->_right(), key);
+        //Adopt the new root's right subtree as the left subtree
+        x->setLeft(newRoot->_right());
+        if (x->_left()) x->_left()->setParent(x);
 
-        //|key| is equal to root's key
-        //Data to retrieve was found
-        return root->_data();
+        //Adopt the old root as the right child
+        newRoot->setRight(x);
+        x->setParent(newRoot);
     }
 
-    //Traverse the tree with |root| in order, displaying all items
-    void displayInorder(Node<T>* root, std::ostream& out = std::cout) const
+    //Rotate |x| to the left, its right child takes its place
+    void rotateLeft(Node<T>* x)
     {
-        if (!root) return;
+        //Push up the right child as the new root of the subtree
+        Node<T>* newRoot = x->_right();
+        replaceChild(x->_parent(), x, newRoot);
+
+        //Adopt the new root's left subtree as the right subtree
+        x->setRight(newRoot->_left());
+        if (x->_right()) x->_right()->setParent(x);
 
-        displayInorder(root->_left(), out);
-        root->display(out);
-        out << '\n';
-        displayInorder(root->_right(), out);
+        //Adopt the old root as the left child
+        newRoot->setLeft(x);
+        x->setParent(newRoot);
     }
 
     //Display the level, data, and color of each node in the tree
@@ -559,34 +764,112 @@ class Tree
 
     //Read in data from |inFile| which was sequentally saved from a previous run of this program
     //The node and matrix read in from this file as well
-    static void readFile(Node<T>*& root, std::ifstream& inFile)
+    //The nodes are read in preorder, each followed by whether it has a left and a right child, then relinked balanced
+    void readFile(std::ifstream& inFile)
+    {
+        //The links still to be read into, the next in preorder last
+        std::vector<Node<T>**> pending(1, &root);
+        size_t count = 0;
+
+        while (!pending.empty())
+        {
+            Node<T>*& link = *pending.back();
+            pending.pop_back();
+
+            link = createNode(inFile);
+            inFile.ignore(1, '\n');
+            ++count;
+
+            int hasLeft = 0;
+            int hasRight = 0;
+            inFile >> hasLeft;
+            inFile >> hasRight;
+            inFile.ignore(1, '\n');
+
+            //Only traverse if there is at least 1 child, the left subtree is read first
+            if (hasRight) pending.push_back(&link->_right());
+            if (hasLeft) pending.push_back(&link->_left());
+        }
+
+        nodeCount = count;
+        rebuild();
+    }
+
+    //Relink every node in order as a balanced tree with valid colors
+    //Every level above the last is complete, so every path to a null leaf passes the same number of black nodes when
+    //only the nodes of an incomplete last level are red
+    void rebuild()
     {
-        root = new Node<T>(inFile);
+        //Collect the nodes in order, the links as read have no parents yet
+        std::vector<Node<T>*> sorted;
+        std::vector<Node<T>*> stack;
+        sorted.reserve(nodeCount);
+
+        for (Node<T>* node = root; node || !stack.empty(); node = node->_right())
+        {
+            for (; node; node = node->_left()) stack.push_back(node);
+
+            node = stack.back();
+            stack.pop_back();
+            sorted.push_back(node);
+        }
+
+        //The number of complete levels
+        size_t complete = 0;
+        while ((size_t(2) << complete) - 1 <= sorted.size()) ++complete;
+
+        //Each range of |sorted| becomes the subtree in |link|, its middle node the root
+        struct Range
+        {
+            size_t begin;
+            size_t end;
+            Node<T>* parent;
+            Node<T>** link;
+            size_t depth;
+        };
+
+        std::vector<Range> ranges(1, Range{0, sorted.size(), nullptr, &root, 0});
 
-        int hasLeft, hasRight;
-        inFile >> hasLeft;
-        inFile >> hasRight;
-        inFile.ignore(1, '\n');
+        while (!ranges.empty())
+        {
+            const Range range = ranges.back();
+            ranges.pop_back();
+
+            if (range.begin == range.end)
+            {
+                *range.link = nullptr;
+                continue;
+            }
+
+            const size_t middle = range.begin + (range.end - range.begin) / 2;
+            Node<T>* node = sorted[middle];
+
+            *range.link = node;
+            node->setParent(range.parent);
+            node->setColor(range.depth < complete ? BLACK : RED);
 
-        //Only traverse if there is at least 1 child
-        if (hasLeft) readFile(root->_left(), inFile);
-        if (hasRight) readFile(root->_right(), inFile);
+            ranges.push_back(Range{middle + 1, range.end, node, &node->_right(), range.depth + 1});
+            ranges.push_back(Range{range.begin, middle, node, &node->_left(), range.depth + 1});
+        }
     }
 
-    //Write all data into |outFile|
-    //Deallocate the entire tree after
+    //Write all data into |outFile| in preorder
     //The node will write out the underlying data to the file using the overloaded operator <<
-    static void writeFile(Node<T>*& root, std::ofstream& outFile)
+    static void writeFile(Node<T>* root, std::ofstream& outFile)
     {
-        if (!root) return;
+        std::vector<Node<T>*> pending;
+        if (root) pending.push_back(root);
 
-        root->writeFile(outFile);
+        while (!pending.empty())
+        {
+            Node<T>* node = pending.back();
+            pending.pop_back();
 
-        writeFile(root->_left(), outFile);
-        writeFile(root->_right(), outFile);
+            node->writeFile(outFile);
 
-        delete root;
-        root = nullptr;
+            if (node->_right()) pending.push_back(node->_right());
+            if (node->_left()) pending.push_back(node->_left());
+        }
     }
 };
 
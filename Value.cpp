@@ -0,0 +1,726 @@
+/*
+@Sean Siders
+sean.siders@icloud.com
+*/
+
+#include "Value.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+
+//////// HELPERS
+
+//The greatest common divisor of two non-negative |int64_t|
+static int64_t gcd64(int64_t a, int64_t b)
+{
+    while (0 != b)
+    {
+        const int64_t r = a % b;
+        a = b;
+        b = r;
+    }
+
+    return a;
+}
+
+//True if |value| can be negated without overflow
+static bool negatable(const int64_t value)
+{
+    return std::numeric_limits<int64_t>::min() != value;
+}
+
+//////// INT CONSTRUCTORS
+
+Int::Int() : negative(false) {}
+
+Int::Int(const int64_t value) : negative(value < 0)
+{
+    //The magnitude is taken unsigned, so the minimum of |int64_t| converts too
+    uint64_t magnitude = negative ? 0 - static_cast<uint64_t>(value) : static_cast<uint64_t>(value);
+
+    while (0 != magnitude)
+    {
+        limbs.push_back(static_cast<uint32_t>(magnitude));
+        magnitude >>= 32;
+    }
+}
+
+//2 raised to |exponent|
+Int Int::powerOfTwo(const size_t exponent)
+{
+    Int result;
+    result.limbs.assign(exponent / 32 + 1, 0);
+    result.limbs.back() = uint32_t(1) << (exponent % 32);
+
+    return result;
+}
+
+//////// INT OPERATORS
+
+Int Int::operator+(const Int& rhs) const
+{
+    Int result;
+
+    if (negative == rhs.negative)
+    {
+        result.limbs = addMagnitude(limbs, rhs.limbs);
+        result.negative = negative;
+    }
+    else if (compareMagnitude(limbs, rhs.limbs) >= 0)
+    {
+        result.limbs = subtractMagnitude(limbs, rhs.limbs);
+        result.negative = negative;
+    }
+    else
+    {
+        result.limbs = subtractMagnitude(rhs.limbs, limbs);
+        result.negative = rhs.negative;
+    }
+
+    result.trim();
+    return result;
+}
+
+Int Int::operator-(const Int& rhs) const
+{
+    return *this + (-rhs);
+}
+
+Int Int::operator*(const Int& rhs) const
+{
+    Int result;
+    if (limbs.empty() || rhs.limbs.empty()) return result;
+
+    result.limbs.assign(limbs.size() + rhs.limbs.size(), 0);
+
+    for (size_t i = 0; i < limbs.size(); ++i)
+    {
+        uint64_t carry = 0;
+
+        //At most (2^32 - 1)^2 + 2 * (2^32 - 1), which is 2^64 - 1
+        for (size_t j = 0; j < rhs.limbs.size(); ++j)
+        {
+            const uint64_t current = static_cast<uint64_t>(limbs[i]) * rhs.limbs[j] + result.limbs[i + j] + carry;
+            result.limbs[i + j] = static_cast<uint32_t>(current);
+            carry = current >> 32;
+        }
+
+        result.limbs[i + rhs.limbs.size()] = static_cast<uint32_t>(carry);
+    }
+
+    result.negative = negative != rhs.negative;
+    result.trim();
+    return result;
+}
+
+Int Int::operator-() const
+{
+    Int result = *this;
+    if (!result.limbs.empty()) result.negative = !negative;
+
+    return result;
+}
+
+bool Int::operator==(const Int& rhs) const
+{
+    return negative == rhs.negative && limbs == rhs.limbs;
+}
+
+bool Int::operator!=(const Int& rhs) const
+{
+    return !(*this == rhs);
+}
+
+//////// INT PUBLIC FUNCTIONS
+
+//Set |quotient| and |remainder| so that |dividend| = |quotient| * |divisor| + |remainder|, the quotient truncated
+//toward zero
+void Int::divide(const Int& dividend, const Int& divisor, Int& quotient, Int& remainder)
+{
+    std::vector<uint32_t> q;
+    std::vector<uint32_t> r;
+    divideMagnitude(dividend.limbs, divisor.limbs, q, r);
+
+    //The signs are taken first, |quotient| may be |dividend|
+    const bool quotientNegative = dividend.negative != divisor.negative;
+    const bool remainderNegative = dividend.negative;
+
+    quotient.limbs = std::move(q);
+    quotient.negative = quotientNegative;
+    quotient.trim();
+
+    remainder.limbs = std::move(r);
+    remainder.negative = remainderNegative;
+    remainder.trim();
+}
+
+//Return the greatest common divisor of |a| and |b|, never negative
+Int Int::gcd(Int a, Int b)
+{
+    a.negative = false;
+    b.negative = false;
+
+    Int quotient;
+    Int remainder;
+
+    while (!b._zero())
+    {
+        divide(a, b, quotient, remainder);
+        a = std::move(b);
+        b = std::move(remainder);
+    }
+
+    return a;
+}
+
+//Return |numerator| / |denominator| rounded to a double, even when neither fits in a double
+//Only the three leading limbs of each take part, which is more than the 53 bits a double holds
+double Int::ratio(const Int& numerator, const Int& denominator)
+{
+    auto leading = [](const Int& value, long& exponent)
+    {
+        const size_t used = std::min<size_t>(3, value.limbs.size());
+        double result = 0.0;
+
+        for (size_t i = value.limbs.size(); i-- > value.limbs.size() - used;)
+            result = result * 4294967296.0 + value.limbs[i];
+
+        exponent = static_cast<long>(32 * (value.limbs.size() - used));
+        return result;
+    };
+
+    long numeratorExponent = 0;
+    long denominatorExponent = 0;
+    const double top = leading(numerator, numeratorExponent);
+    const double bottom = leading(denominator, denominatorExponent);
+
+    const double result = std::ldexp(top / bottom, static_cast<int>(numeratorExponent - denominatorExponent));
+    return (numerator.negative != denominator.negative) ? -result : result;
+}
+
+//True if the value fits in an |int64_t| other than its minimum, which is then written into |value|
+bool Int::small(int64_t& value) const
+{
+    if (limbs.size() > 2) return false;
+
+    uint64_t magnitude = 0;
+    for (size_t i = limbs.size(); i-- > 0;) magnitude = (magnitude << 32) | limbs[i];
+
+    if (magnitude > static_cast<uint64_t>(std::numeric_limits<int64_t>::max())) return false;
+
+    value = negative ? -static_cast<int64_t>(magnitude) : static_cast<int64_t>(magnitude);
+    return true;
+}
+
+//Return the value in decimal
+//The magnitude is divided by 10^9 repeatedly, each remainder is nine digits of the result
+std::string Int::text() const
+{
+    if (limbs.empty()) return "0";
+
+    std::vector<uint32_t> magnitude = limbs;
+    std::vector<uint32_t> chunks;
+
+    while (!magnitude.empty())
+    {
+        uint64_t remainder = 0;
+
+        for (size_t i = magnitude.size(); i-- > 0;)
+        {
+            const uint64_t current = (remainder << 32) | magnitude[i];
+            magnitude[i] = static_cast<uint32_t>(current / 1000000000);
+            remainder = current % 1000000000;
+        }
+
+        while (!magnitude.empty() && 0 == magnitude.back()) magnitude.pop_back();
+        chunks.push_back(static_cast<uint32_t>(remainder));
+    }
+
+    std::string result = negative ? "-" : "";
+    result += std::to_string(chunks.back());
+
+    char digits[16];
+
+    for (size_t i = chunks.size() - 1; i-- > 0;)
+    {
+        std::snprintf(digits, sizeof(digits), "%09u", chunks[i]);
+        result += digits;
+    }
+
+    return result;
+}
+
+//////// INT PRIVATE FUNCTIONS
+
+//Drop leading zero limbs, zero is never negative
+void Int::trim()
+{
+    while (!limbs.empty() && 0 == limbs.back()) limbs.pop_back();
+    if (limbs.empty()) negative = false;
+}
+
+//Return -1, 0 or 1 as the magnitude of |a| is below, equal to or above the magnitude of |b|
+int Int::compareMagnitude(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b)
+{
+    if (a.size() != b.size()) return (a.size() < b.size()) ? -1 : 1;
+
+    for (size_t i = a.size(); i-- > 0;)
+        if (a[i] != b[i]) return (a[i] < b[i]) ? -1 : 1;
+
+    return 0;
+}
+
+//Return the sum of the magnitudes |a| and |b|
+std::vector<uint32_t> Int::addMagnitude(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b)
+{
+    const std::vector<uint32_t>& longer = (a.size() >= b.size()) ? a : b;
+    const std::vector<uint32_t>& shorter = (a.size() >= b.size()) ? b : a;
+
+    std::vector<uint32_t> result(longer.size() + 1, 0);
+    uint64_t carry = 0;
+
+    for (size_t i = 0; i < longer.size(); ++i)
+    {
+        const uint64_t sum = static_cast<uint64_t>(longer[i]) + (i < shorter.size() ? shorter[i] : 0) + carry;
+        result[i] = static_cast<uint32_t>(sum);
+        carry = sum >> 32;
+    }
+
+    result[longer.size()] = static_cast<uint32_t>(carry);
+    return result;
+}
+
+//Return the magnitude |a| - |b|, |a| must be no smaller than |b|
+std::vector<uint32_t> Int::subtractMagnitude(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b)
+{
+    std::vector<uint32_t> result(a.size(), 0);
+    int64_t borrow = 0;
+
+    for (size_t i = 0; i < a.size(); ++i)
+    {
+        const int64_t difference = static_cast<int64_t>(a[i]) - (i < b.size() ? b[i] : 0) - borrow;
+        result[i] = static_cast<uint32_t>(difference);
+        borrow = (difference < 0) ? 1 : 0;
+    }
+
+    return result;
+}
+
+//Set |quotient| and |remainder| to the quotient and remainder of the magnitudes |u| / |v|
+//A divisor of several limbs uses Knuth's algorithm D: the divisor is shifted until its leading bit is set, so the
+//estimate of each quotient limb from the two leading limbs of the remainder is off by at most 2
+void Int::divideMagnitude(const std::vector<uint32_t>& u, const std::vector<uint32_t>& v,
+                          std::vector<uint32_t>& quotient, std::vector<uint32_t>& remainder)
+{
+    const uint64_t base = uint64_t(1) << 32;
+
+    if (compareMagnitude(u, v) < 0)
+    {
+        quotient.clear();
+        remainder = u;
+        return;
+    }
+
+    const size_t n = v.size();
+
+    if (1 == n)
+    {
+        uint64_t rest = 0;
+        quotient.assign(u.size(), 0);
+
+        for (size_t i = u.size(); i-- > 0;)
+        {
+            const uint64_t current = (rest << 32) | u[i];
+            quotient[i] = static_cast<uint32_t>(current / v[0]);
+            rest = current % v[0];
+        }
+
+        remainder.clear();
+        if (0 != rest) remainder.push_back(static_cast<uint32_t>(rest));
+    }
+    else
+    {
+        const size_t m = u.size() - n;
+        const int shift = __builtin_clz(v[n - 1]);
+
+        //Shift both so the leading limb of the divisor has its top bit set, |un| gains a limb for the overflow
+        auto shifted = [shift](const std::vector<uint32_t>& source, const size_t i)
+        {
+            const uint64_t high = static_cast<uint64_t>(source[i]) << shift;
+            const uint64_t low = (0 == shift || 0 == i) ? 0 : static_cast<uint64_t>(source[i - 1]) >> (32 - shift);
+            return static_cast<uint32_t>(high | low);
+        };
+
+        std::vector<uint32_t> vn(n);
+        std::vector<uint32_t> un(u.size() + 1);
+
+        for (size_t i = 0; i < n; ++i) vn[i] = shifted(v, i);
+        for (size_t i = 0; i < u.size(); ++i) un[i] = shifted(u, i);
+        un[u.size()] = (0 == shift) ? 0 : static_cast<uint32_t>(static_cast<uint64_t>(u.back()) >> (32 - shift));
+
+        quotient.assign(m + 1, 0);
+
+        for (size_t j = m + 1; j-- > 0;)
+        {
+            //Estimate the quotient limb from the leading limbs, then correct it down
+            const uint64_t top = (static_cast<uint64_t>(un[j + n]) << 32) | un[j + n - 1];
+            uint64_t qhat = top / vn[n - 1];
+            uint64_t rhat = top % vn[n - 1];
+
+            while (qhat >= base || qhat * vn[n - 2] > ((rhat << 32) | un[j + n - 2]))
+            {
+                --qhat;
+                rhat += vn[n - 1];
+                if (rhat >= base) break;
+            }
+
+            //Subtract qhat * vn from the current window of un
+            uint64_t carry = 0;
+            int64_t borrow = 0;
+
+            for (size_t i = 0; i < n; ++i)
+            {
+                const uint64_t product = qhat * vn[i] + carry;
+                carry = product >> 32;
+
+                const int64_t low = static_cast<int64_t>(product & 0xFFFFFFFF);
+                const int64_t difference = static_cast<int64_t>(un[i + j]) - borrow - low;
+                un[i + j] = static_cast<uint32_t>(difference);
+                borrow = (difference < 0) ? 1 : 0;
+            }
+
+            const int64_t difference = static_cast<int64_t>(un[j + n]) - borrow - static_cast<int64_t>(carry);
+            un[j + n] = static_cast<uint32_t>(difference);
+
+            //The estimate was one too large, add the divisor back
+            if (difference < 0)
+            {
+                --qhat;
+                uint64_t sumCarry = 0;
+
+                for (size_t i = 0; i < n; ++i)
+                {
+                    const uint64_t sum = static_cast<uint64_t>(un[i + j]) + vn[i] + sumCarry;
+                    un[i + j] = static_cast<uint32_t>(sum);
+                    sumCarry = sum >> 32;
+                }
+
+                un[j + n] += static_cast<uint32_t>(sumCarry);
+            }
+
+            quotient[j] = static_cast<uint32_t>(qhat);
+        }
+
+        //Shift the remainder back
+        remainder.assign(n, 0);
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            const uint64_t low = static_cast<uint64_t>(un[i]) >> shift;
+            const uint64_t high = (0 == shift) ? 0 : static_cast<uint64_t>(un[i + 1]) << (32 - shift);
+            remainder[i] = static_cast<uint32_t>(low | high);
+        }
+    }
+
+    while (!quotient.empty() && 0 == quotient.back()) quotient.pop_back();
+    while (!remainder.empty() && 0 == remainder.back()) remainder.pop_back();
+}
+
+//////// FRACTION CONSTRUCTORS
+
+//Zero
+Fraction::Fraction() : numerator(0), denominator(1) {}
+
+//|numerator| / |denominator|, |denominator| must not be zero
+Fraction::Fraction(const int64_t numerator, const int64_t denominator) : numerator(numerator), denominator(denominator)
+{
+    //The minimum of |int64_t| is never held small, it could not be negated
+    if (denominator > 0 && negatable(numerator)) return;
+
+    if (negatable(numerator) && negatable(denominator))
+    {
+        this->numerator = -numerator;
+        this->denominator = -denominator;
+    }
+    else *this = exact(Int(numerator), Int(denominator));
+}
+
+//|numerator| / |denominator|, |denominator| must not be zero
+Fraction::Fraction(const Int& numerator, const Int& denominator) : Fraction()
+{
+    *this = exact(numerator, denominator);
+}
+
+//Return the fraction with the smallest denominator that rounds to |value|
+//The convergents of the continued fraction of |value| are tried in turn, each is the closest fraction to |value| of
+//denominators up to its own, so the first that rounds to |value| has the smallest denominator
+//Convergents are only trusted while both of their terms convert to doubles exactly
+Fraction Fraction::nearest(const double value)
+{
+    const int64_t exactLimit = int64_t(1) << 53;
+    const double magnitude = std::fabs(value);
+
+    if (0.0 == magnitude) return Fraction();
+
+    double rest = magnitude;
+    int64_t previousNumerator = 0;
+    int64_t previousDenominator = 1;
+    int64_t currentNumerator = 1;
+    int64_t currentDenominator = 0;
+
+    for (size_t term = 0; term < 64 && rest < static_cast<double>(exactLimit); ++term)
+    {
+        const double whole = std::floor(rest);
+        const int64_t a = static_cast<int64_t>(whole);
+
+        int64_t nextNumerator = 0;
+        int64_t nextDenominator = 0;
+
+        if (__builtin_mul_overflow(a, currentNumerator, &nextNumerator) ||
+            __builtin_add_overflow(nextNumerator, previousNumerator, &nextNumerator) ||
+            __builtin_mul_overflow(a, currentDenominator, &nextDenominator) ||
+            __builtin_add_overflow(nextDenominator, previousDenominator, &nextDenominator) ||
+            nextNumerator > exactLimit || nextDenominator > exactLimit) break;
+
+        previousNumerator = currentNumerator;
+        previousDenominator = currentDenominator;
+        currentNumerator = nextNumerator;
+        currentDenominator = nextDenominator;
+
+        if (static_cast<double>(currentNumerator) / static_cast<double>(currentDenominator) == magnitude)
+            return Fraction((value < 0) ? -currentNumerator : currentNumerator, currentDenominator);
+
+        if (rest == whole) break;
+        rest = 1.0 / (rest - whole);
+    }
+
+    //Every double is an integer of 53 bits times a power of 2
+    int exponent = 0;
+    const double mantissa = std::frexp(magnitude, &exponent);
+    const Int scaled(static_cast<int64_t>(std::ldexp(mantissa, 53)) * ((value < 0) ? -1 : 1));
+    exponent -= 53;
+
+    if (exponent >= 0) return exact(scaled * Int::powerOfTwo(exponent), Int(1));
+    return exact(scaled, Int::powerOfTwo(-exponent));
+}
+
+//////// FRACTION OPERATORS
+
+Fraction Fraction::operator+(const Fraction& rhs) const
+{
+    if (!big && !rhs.big)
+    {
+        int64_t n = 0;
+        int64_t d = 0;
+        int64_t left = 0;
+        int64_t right = 0;
+
+        if (denominator == rhs.denominator)
+        {
+            if (!__builtin_add_overflow(numerator, rhs.numerator, &n) && negatable(n)) return settled(n, denominator);
+        }
+        else if (!__builtin_mul_overflow(numerator, rhs.denominator, &left) &&
+                 !__builtin_mul_overflow(rhs.numerator, denominator, &right) &&
+                 !__builtin_add_overflow(left, right, &n) && negatable(n) &&
+                 !__builtin_mul_overflow(denominator, rhs.denominator, &d)) return settled(n, d);
+
+        //Retry with reduced operands over the least common denominator
+        Fraction a = *this;
+        Fraction b = rhs;
+        a.reduce();
+        b.reduce();
+
+        const int64_t g = gcd64(a.denominator, b.denominator);
+
+        if (!__builtin_mul_overflow(a.numerator, b.denominator / g, &left) &&
+            !__builtin_mul_overflow(b.numerator, a.denominator / g, &right) &&
+            !__builtin_add_overflow(left, right, &n) && negatable(n) &&
+            !__builtin_mul_overflow(a.denominator, b.denominator / g, &d)) return settled(n, d);
+    }
+
+    const Int rhsDenominator = rhs.bigDenominator();
+    const Int lhsDenominator = bigDenominator();
+
+    return exact(bigNumerator() * rhsDenominator + rhs.bigNumerator() * lhsDenominator, lhsDenominator * rhsDenominator);
+}
+
+Fraction Fraction::operator-(const Fraction& rhs) const
+{
+    return *this + (-rhs);
+}
+
+Fraction Fraction::operator*(const Fraction& rhs) const
+{
+    if (!big && !rhs.big)
+    {
+        int64_t n = 0;
+        int64_t d = 0;
+
+        if (!__builtin_mul_overflow(numerator, rhs.numerator, &n) && negatable(n) &&
+            !__builtin_mul_overflow(denominator, rhs.denominator, &d)) return settled(n, d);
+
+        //Retry after cancelling across the operands
+        const int64_t first = gcd64(std::abs(numerator), rhs.denominator);
+        const int64_t second = gcd64(std::abs(rhs.numerator), denominator);
+
+        if (!__builtin_mul_overflow(numerator / first, rhs.numerator / second, &n) && negatable(n) &&
+            !__builtin_mul_overflow(denominator / second, rhs.denominator / first, &d)) return settled(n, d);
+    }
+
+    return exact(bigNumerator() * rhs.bigNumerator(), bigDenominator() * rhs.bigDenominator());
+}
+
+//|rhs| must not be zero
+//A whole number divided by one of its divisors stays whole, which keeps fraction-free elimination on the fast path
+Fraction Fraction::operator/(const Fraction& rhs) const
+{
+    if (!big && !rhs.big && 1 == denominator && 1 == rhs.denominator && 0 == numerator % rhs.numerator)
+        return Fraction(numerator / rhs.numerator);
+
+    Fraction reciprocal;
+
+    if (rhs.big) reciprocal = exact(rhs.big->denominator, rhs.big->numerator);
+    else if (rhs.numerator > 0)
+    {
+        reciprocal.numerator = rhs.denominator;
+        reciprocal.denominator = rhs.numerator;
+    }
+    else
+    {
+        reciprocal.numerator = -rhs.denominator;
+        reciprocal.denominator = -rhs.numerator;
+    }
+
+    return *this * reciprocal;
+}
+
+Fraction Fraction::operator-() const
+{
+    Fraction result = *this;
+
+    if (big) result.big = std::make_shared<const Big>(Big{-big->numerator, big->denominator});
+    else result.numerator = -numerator;
+
+    return result;
+}
+
+Fraction& Fraction::operator+=(const Fraction& rhs)
+{
+    return *this = *this + rhs;
+}
+
+Fraction& Fraction::operator-=(const Fraction& rhs)
+{
+    return *this = *this - rhs;
+}
+
+//Small fractions are compared by cross multiplication in 128 bits, so neither needs to be reduced
+//Promoted fractions are always reduced, and a promoted fraction never equals a small one
+bool Fraction::operator==(const Fraction& rhs) const
+{
+    if (!big && !rhs.big)
+        return static_cast<__int128>(numerator) * rhs.denominator == static_cast<__int128>(rhs.numerator) * denominator;
+
+    if (big && rhs.big) return big->numerator == rhs.big->numerator && big->denominator == rhs.big->denominator;
+
+    return false;
+}
+
+bool Fraction::operator!=(const Fraction& rhs) const
+{
+    return !(*this == rhs);
+}
+
+//////// FRACTION PUBLIC FUNCTIONS
+
+//Return the value rounded to a double
+double Fraction::toDouble() const
+{
+    if (big) return Int::ratio(big->numerator, big->denominator);
+
+    return static_cast<double>(numerator) / static_cast<double>(denominator);
+}
+
+//Return the reduced fraction as "n/d", or "n" when the denominator is 1
+std::string Fraction::text() const
+{
+    if (big)
+    {
+        if (Int(1) == big->denominator) return big->numerator.text();
+        return big->numerator.text() + "/" + big->denominator.text();
+    }
+
+    Fraction reduced = *this;
+    reduced.reduce();
+
+    if (1 == reduced.denominator) return std::to_string(reduced.numerator);
+    return std::to_string(reduced.numerator) + "/" + std::to_string(reduced.denominator);
+}
+
+//The numerator and denominator as |Int|, the denominator is positive but the fraction may not be reduced
+Int Fraction::bigNumerator() const
+{
+    return big ? big->numerator : Int(numerator);
+}
+
+Int Fraction::bigDenominator() const
+{
+    return big ? big->denominator : Int(denominator);
+}
+
+//////// FRACTION PRIVATE FUNCTIONS
+
+//Return |numerator| / |denominator| as a small fraction, reducing it if it has grown past |FRACTION_REDUCE_LIMIT|
+Fraction Fraction::settled(const int64_t numerator, const int64_t denominator)
+{
+    Fraction result;
+    result.numerator = numerator;
+    result.denominator = denominator;
+
+    if (denominator > FRACTION_REDUCE_LIMIT || numerator > FRACTION_REDUCE_LIMIT || numerator < -FRACTION_REDUCE_LIMIT)
+        result.reduce();
+
+    return result;
+}
+
+//Return |numerator| / |denominator| reduced, as a small fraction if it fits
+Fraction Fraction::exact(Int numerator, Int denominator)
+{
+    if (denominator._negative())
+    {
+        numerator = -numerator;
+        denominator = -denominator;
+    }
+
+    //A whole number needs no gcd
+    const Int g = (Int(1) == denominator) ? denominator : Int::gcd(numerator, denominator);
+
+    if (Int(1) != g)
+    {
+        Int remainder;
+        Int::divide(numerator, g, numerator, remainder);
+        Int::divide(denominator, g, denominator, remainder);
+    }
+
+    Fraction result;
+    if (numerator.small(result.numerator) && denominator.small(result.denominator)) return result;
+
+    result.numerator = 0;
+    result.denominator = 1;
+    result.big = std::make_shared<const Big>(Big{std::move(numerator), std::move(denominator)});
+
+    return result;
+}
+
+//Divide the small numerator and denominator by their gcd
+void Fraction::reduce()
+{
+    const int64_t g = gcd64(std::abs(numerator), denominator);
+
+    if (g > 1)
+    {
+        numerator /= g;
+        denominator /= g;
+    }
+}
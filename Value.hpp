@@ -1,19 +1,115 @@
+/*
+Exact numeric values for the rational matrices of |Rational.hpp|.
+
+INT
+|Int| is an integer of any size, kept as a sign and a magnitude of 32 bit limbs, least significant first. It is only
+used once a value no longer fits in 64 bits, so its arithmetic favors simplicity : schoolbook multiplication and Knuth's
+long division.
+
+FRACTION
+|Fraction| is an exact rational number. Its numerator and denominator are held in |int64_t| as long as they fit, and
+every small operation is a handful of integer instructions with overflow checks :
+- Sums of fractions with equal denominators only add numerators
+- Fractions are not reduced after every operation, the gcd is only taken once the numerator or denominator grows past
+  |FRACTION_REDUCE_LIMIT|, or when the fraction is displayed (lazy normalization)
+- An operation that overflows is retried with reduced operands, and only when that overflows too are the operands
+  promoted to |Int|. A promoted result is always reduced, and is demoted back to |int64_t| once it fits again
+
+Typical small valued matrices therefore never leave the fast path, and exact results cost a small constant factor over
+doubles rather than the cost of arbitrary precision arithmetic.
+
+@Sean Siders
+sean.siders@icloud.com
+*/
+
 #ifndef VALUE_HPP_
 #define VALUE_HPP_
 
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+//A small fraction is reduced once its numerator or denominator grows past this
+const int64_t FRACTION_REDUCE_LIMIT = int64_t(1) << 32;
+
 class Value
 {
     public:
-    Value();
+    Value() {}
 
     private:
 };
 
+//An integer of any size
 class Int : public Value
 {
     public:
+    //////// CONSTRUCTORS
+
+    Int();
+    Int(const int64_t value);
+
+    //2 raised to |exponent|
+    static Int powerOfTwo(const size_t exponent);
+
+    //////// OPERATORS
+
+    Int operator+(const Int& rhs) const;
+    Int operator-(const Int& rhs) const;
+    Int operator*(const Int& rhs) const;
+    Int operator-() const;
+    bool operator==(const Int& rhs) const;
+    bool operator!=(const Int& rhs) const;
+
+    //////// PUBLIC FUNCTIONS
+
+    //Set |quotient| and |remainder| so that |dividend| = |quotient| * |divisor| + |remainder|, the quotient truncated
+    //toward zero
+    //|divisor| must not be zero
+    static void divide(const Int& dividend, const Int& divisor, Int& quotient, Int& remainder);
+
+    //Return the greatest common divisor of |a| and |b|, never negative
+    static Int gcd(Int a, Int b);
+
+    //Return |numerator| / |denominator| rounded to a double, even when neither fits in a double
+    static double ratio(const Int& numerator, const Int& denominator);
+
+    //True if the value fits in an |int64_t| other than its minimum, which is then written into |value|
+    //The minimum is excluded so that every small value can be negated
+    bool small(int64_t& value) const;
+
+    //Return the value in decimal
+    std::string text() const;
+
+    //////// GETTERS
+
+    bool _zero() const { return limbs.empty(); }
+
+    bool _negative() const { return negative; }
 
     private:
+    //True if the value is below zero, zero is never negative
+    bool negative;
+
+    //The magnitude, least significant limb first, with no leading zero limbs
+    std::vector<uint32_t> limbs;
+
+    //Drop leading zero limbs, zero is never negative
+    void trim();
+
+    //Return -1, 0 or 1 as the magnitude of |a| is below, equal to or above the magnitude of |b|
+    static int compareMagnitude(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b);
+
+    //Return the sum of the magnitudes |a| and |b|
+    static std::vector<uint32_t> addMagnitude(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b);
+
+    //Return the magnitude |a| - |b|, |a| must be no smaller than |b|
+    static std::vector<uint32_t> subtractMagnitude(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b);
+
+    //Set |quotient| and |remainder| to the quotient and remainder of the magnitudes |u| / |v|, |v| must not be zero
+    static void divideMagnitude(const std::vector<uint32_t>& u, const std::vector<uint32_t>& v,
+                                std::vector<uint32_t>& quotient, std::vector<uint32_t>& remainder);
 };
 
 class Float : public Value
@@ -23,11 +119,85 @@ class Float : public Value
     private:
 };
 
+//An exact rational number
 class Fraction : public Value
 {
     public:
+    //////// CONSTRUCTORS
+
+    //Zero
+    Fraction();
+
+    //|numerator| / |denominator|, |denominator| must not be zero
+    Fraction(const int64_t numerator, const int64_t denominator = 1);
+
+    //|numerator| / |denominator|, |denominator| must not be zero
+    Fraction(const Int& numerator, const Int& denominator);
+
+    //Return the fraction with the smallest denominator that rounds to |value|, so 0.1 becomes 1/10
+    //A value no such fraction of 64 bit integers rounds to is converted exactly, as an integer times a power of 2
+    //|value| must be finite
+    static Fraction nearest(const double value);
+
+    //////// OPERATORS
+
+    Fraction operator+(const Fraction& rhs) const;
+    Fraction operator-(const Fraction& rhs) const;
+    Fraction operator*(const Fraction& rhs) const;
+
+    //|rhs| must not be zero
+    Fraction operator/(const Fraction& rhs) const;
+
+    Fraction operator-() const;
+    Fraction& operator+=(const Fraction& rhs);
+    Fraction& operator-=(const Fraction& rhs);
+    bool operator==(const Fraction& rhs) const;
+    bool operator!=(const Fraction& rhs) const;
+
+    //////// PUBLIC FUNCTIONS
+
+    //Return the value rounded to a double
+    double toDouble() const;
+
+    //Return the reduced fraction as "n/d", or "n" when the denominator is 1
+    std::string text() const;
+
+    //The numerator and denominator as |Int|, the denominator is positive but the fraction may not be reduced
+    Int bigNumerator() const;
+    Int bigDenominator() const;
+
+    //////// GETTERS
+
+    bool _zero() const { return big ? big->numerator._zero() : 0 == numerator; }
+
+    //True if the fraction no longer fits in |int64_t| and is held as |Int|
+    bool _big() const { return static_cast<bool>(big); }
 
     private:
+    //A fraction too large for |int64_t|, always reduced and with a positive denominator
+    struct Big
+    {
+        Int numerator;
+        Int denominator;
+    };
+
+    //The fraction while it fits, the denominator is always positive
+    int64_t numerator;
+    int64_t denominator;
+
+    //The fraction once it has been promoted, null while it fits
+    //Promoted values are never changed, so copies share them
+    std::shared_ptr<const Big> big;
+
+    //Return |numerator| / |denominator| as a small fraction, reducing it if it has grown past |FRACTION_REDUCE_LIMIT|
+    //|denominator| must be positive
+    static Fraction settled(const int64_t numerator, const int64_t denominator);
+
+    //Return |numerator| / |denominator| reduced, as a small fraction if it fits
+    static Fraction exact(Int numerator, Int denominator);
+
+    //Divide the small numerator and denominator by their gcd
+    void reduce();
 };
 
 #endif //VALUE_HPP_